@@ -8,6 +8,10 @@
 #include <stdarg.h>
 #include <string.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct bitmap bitmap_t;
 
 // WARNING: Bit requests outside the bitmap and NULL pointers WILL result in a segfault
@@ -143,5 +147,8 @@ bitmap_t *bitmap_overlay(const size_t n_bits, void *const bitmap_data);
 ///
 void bitmap_destroy(bitmap_t *bitmap);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif
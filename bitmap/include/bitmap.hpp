@@ -0,0 +1,319 @@
+#ifndef BITMAP_HPP__
+#define BITMAP_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+
+#include "bitmap.h"
+
+// Header-only C++ counterparts to bitmap_t
+// Everything in here is visible to the compiler, so tight loops collapse into a handful of
+// instructions instead of a PLT call per bit. Same rules as the C version apply:
+// bit requests outside the bitmap WILL cause bad things, we assume you're using it right.
+
+namespace osf {
+
+namespace bitmap_detail {
+
+// SIZE_MAX, same not found value as the C library
+constexpr size_t npos = SIZE_MAX;
+
+// Count trailing zeros, w MUST be non-zero
+template <typename Word>
+inline size_t ctz(const Word w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(Word) <= sizeof(unsigned) ? (size_t) __builtin_ctz((unsigned) w)
+           : sizeof(Word) <= sizeof(unsigned long) ? (size_t) __builtin_ctzl((unsigned long) w)
+           : (size_t) __builtin_ctzll((unsigned long long) w);
+#else
+    size_t result = 0;
+    for (Word walker = w; !(walker & 0x01); walker >>= 1) { ++result; }
+    return result;
+#endif
+}
+
+template <typename Word>
+inline size_t popcount(const Word w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(Word) <= sizeof(unsigned) ? (size_t) __builtin_popcount((unsigned) w)
+           : sizeof(Word) <= sizeof(unsigned long) ? (size_t) __builtin_popcountl((unsigned long) w)
+           : (size_t) __builtin_popcountll((unsigned long long) w);
+#else
+    size_t result = 0;
+    for (Word walker = w; walker; walker &= walker - 1) { ++result; }
+    return result;
+#endif
+}
+
+}  // namespace bitmap_detail
+
+///
+/// Fixed-size bitmap, storage is N bits rounded up to whole Words
+/// Bits past N in the last word are kept at zero so the scans never report them
+///
+template <size_t N, typename Word = unsigned long>
+class bitmap {
+    static_assert(N > 0, "bitmap must have at least one bit");
+    static_assert(std::is_unsigned<Word>::value, "bitmap Word must be an unsigned integer type");
+
+  public:
+    typedef Word word_type;
+
+    static constexpr size_t npos = bitmap_detail::npos;
+    static constexpr size_t word_bits = sizeof(Word) * CHAR_BIT;
+    static constexpr size_t word_count = (N + word_bits - 1) / word_bits;
+    static constexpr size_t leftover_bits = N % word_bits;
+
+    ///
+    /// Zero initialized, same as bitmap_create
+    ///
+    bitmap() : words_() {}
+
+    static constexpr size_t get_bits() { return N; }
+    static constexpr size_t get_bytes() { return word_count * sizeof(Word); }
+
+    static constexpr size_t word_index(const size_t bit) { return bit / word_bits; }
+    static constexpr Word bit_mask(const size_t bit) { return Word(1) << (bit % word_bits); }
+    // bit and everything above it in its word. Shifted as a Word, so narrow words don't shift a negative int
+    static constexpr Word from_mask(const size_t bit) { return Word(Word(~Word(0)) << (bit % word_bits)); }
+
+    void set(const size_t bit) { words_[word_index(bit)] |= bit_mask(bit); }
+    void reset(const size_t bit) { words_[word_index(bit)] &= ~bit_mask(bit); }
+    void flip(const size_t bit) { words_[word_index(bit)] ^= bit_mask(bit); }
+    bool test(const size_t bit) const { return words_[word_index(bit)] & bit_mask(bit); }
+
+    void invert() {
+        for (size_t idx = 0; idx < word_count; ++idx) {
+            words_[idx] = ~words_[idx];
+        }
+        trim();
+    }
+
+    ///
+    /// Unlike the C version, the pattern is a full word and the tail is always accurate
+    /// \param pattern The pattern to apply to all words
+    ///
+    void format(const Word pattern) {
+        for (size_t idx = 0; idx < word_count; ++idx) {
+            words_[idx] = pattern;
+        }
+        trim();
+    }
+
+    ///
+    /// Find first set
+    /// \return The first one bit address, npos if not found
+    ///
+    size_t ffs() const { return next_set(0); }
+
+    ///
+    /// Find first zero
+    /// \return The first zero bit address, npos if not found
+    ///
+    size_t ffz() const { return next_zero(0); }
+
+    ///
+    /// Resumeable ffs, searches from (and including) the given bit
+    /// \param bit The bit to start at
+    /// \return The next one bit address, npos if not found
+    ///
+    size_t next_set(const size_t bit) const {
+        if (bit < N) {
+            size_t idx = word_index(bit);
+            Word current = words_[idx] & from_mask(bit);
+            while (!current) {
+                if (++idx == word_count) {
+                    return npos;
+                }
+                current = words_[idx];
+            }
+            return idx * word_bits + bitmap_detail::ctz(current);
+        }
+        return npos;
+    }
+
+    ///
+    /// Resumeable ffz, searches from (and including) the given bit
+    /// \param bit The bit to start at
+    /// \return The next zero bit address, npos if not found
+    ///
+    size_t next_zero(const size_t bit) const {
+        if (bit < N) {
+            size_t idx = word_index(bit);
+            Word current = Word(~words_[idx]) & from_mask(bit);
+            while (!current) {
+                if (++idx == word_count) {
+                    return npos;
+                }
+                current = Word(~words_[idx]);
+            }
+            // the padding bits are zero, so inverted they'd look free. Don't let them out.
+            const size_t result = idx * word_bits + bitmap_detail::ctz(current);
+            return result < N ? result : npos;
+        }
+        return npos;
+    }
+
+    ///
+    /// Count all bits set
+    /// \return the total number of bits that are set in the bitmap
+    ///
+    size_t total_set() const {
+        size_t total = 0;
+        for (size_t idx = 0; idx < word_count; ++idx) {
+            total += bitmap_detail::popcount(words_[idx]);
+        }
+        return total;
+    }
+
+    ///
+    /// For each loop for all set bits
+    /// Takes anything callable with a size_t, so lambdas inline right into the loop
+    /// \param func The function to apply to each set bit number
+    ///
+    template <typename Func>
+    void for_each(Func func) const {
+        for (size_t idx = 0; idx < word_count; ++idx) {
+            // clear lowest set bit each round, only loops as many times as there are bits set
+            for (Word current = words_[idx]; current; current &= current - 1) {
+                func(idx * word_bits + bitmap_detail::ctz(current));
+            }
+        }
+    }
+
+    Word *data() { return words_; }
+    const Word *data() const { return words_; }
+
+  private:
+    // Keeps the bits past N at zero
+    void trim() {
+        if (leftover_bits) {
+            words_[word_count - 1] &= (Word(1) << leftover_bits) - 1;
+        }
+    }
+
+    Word words_[word_count];
+};
+
+template <size_t N, typename Word>
+constexpr size_t bitmap<N, Word>::npos;
+template <size_t N, typename Word>
+constexpr size_t bitmap<N, Word>::word_bits;
+template <size_t N, typename Word>
+constexpr size_t bitmap<N, Word>::word_count;
+template <size_t N, typename Word>
+constexpr size_t bitmap<N, Word>::leftover_bits;
+
+
+///
+/// Inlinable view over existing byte-based bitmap storage (a bitmap_t, or anything in its format)
+/// The view does not own the storage, the bitmap_t must outlive it
+/// Byte layout matches the C library exactly, bit b lives in byte b >> 3 at mask 1 << (b & 7)
+///
+class bitmap_view {
+  public:
+    static constexpr size_t npos = bitmap_detail::npos;
+
+    bitmap_view(uint8_t *const data, const size_t n_bits) : data_(data), bit_count_(n_bits) {}
+
+    // export hands out a const pointer, but we know it's ours to poke at
+    explicit bitmap_view(bitmap_t *const bitmap)
+        : data_(const_cast<uint8_t *>(bitmap_export(bitmap))), bit_count_(bitmap_get_bits(bitmap)) {}
+
+    size_t get_bits() const { return bit_count_; }
+    size_t get_bytes() const { return (bit_count_ + 7) >> 3; }
+
+    void set(const size_t bit) { data_[bit >> 3] |= uint8_t(1u << (bit & 0x07)); }
+    void reset(const size_t bit) { data_[bit >> 3] &= uint8_t(~(1u << (bit & 0x07))); }
+    void flip(const size_t bit) { data_[bit >> 3] ^= uint8_t(1u << (bit & 0x07)); }
+    bool test(const size_t bit) const { return data_[bit >> 3] & (1u << (bit & 0x07)); }
+
+    ///
+    /// Find first set
+    /// \return The first one bit address, npos if not found
+    ///
+    size_t ffs() const { return scan(0x00); }
+
+    ///
+    /// Find first zero
+    /// \return The first zero bit address, npos if not found
+    ///
+    size_t ffz() const { return scan(0xFF); }
+
+    ///
+    /// Count all bits set (ignores the undetermined bits past the bit count)
+    /// \return the total number of bits that are set in the bitmap
+    ///
+    size_t total_set() const {
+        const size_t full_bytes = bit_count_ >> 3;
+        size_t total = 0, idx = 0;
+        for (; idx + sizeof(uint64_t) <= full_bytes; idx += sizeof(uint64_t)) {
+            uint64_t chunk;
+            memcpy(&chunk, data_ + idx, sizeof(chunk));
+            total += bitmap_detail::popcount(chunk);
+        }
+        for (; idx < full_bytes; ++idx) {
+            total += bitmap_detail::popcount(data_[idx]);
+        }
+        if (bit_count_ & 0x07) {
+            total += bitmap_detail::popcount(uint8_t(data_[idx] & ((1u << (bit_count_ & 0x07)) - 1)));
+        }
+        return total;
+    }
+
+    ///
+    /// For each loop for all set bits
+    /// \param func The function to apply to each set bit number
+    ///
+    template <typename Func>
+    void for_each(Func func) const {
+        const size_t byte_count = get_bytes();
+        for (size_t idx = 0; idx < byte_count; ++idx) {
+            for (unsigned current = data_[idx]; current; current &= current - 1) {
+                const size_t bit = (idx << 3) + bitmap_detail::ctz(current);
+                if (bit >= bit_count_) {
+                    return;
+                }
+                func(bit);
+            }
+        }
+    }
+
+    uint8_t *data() { return data_; }
+    const uint8_t *data() const { return data_; }
+
+  private:
+    // Finds the first byte that isn't the uniform skip value, then the first bit in it that differs
+    // Skips in 8 byte chunks. memcpy keeps it alignment safe and compiles down to a plain load.
+    size_t scan(const uint8_t skip) const {
+        const size_t byte_count = get_bytes();
+        uint64_t skip_chunk;
+        memset(&skip_chunk, skip, sizeof(skip_chunk));
+        size_t idx = 0;
+        for (; idx + sizeof(uint64_t) <= byte_count; idx += sizeof(uint64_t)) {
+            uint64_t chunk;
+            memcpy(&chunk, data_ + idx, sizeof(chunk));
+            if (chunk != skip_chunk) {
+                break;
+            }
+        }
+        for (; idx < byte_count; ++idx) {
+            const unsigned diff = data_[idx] ^ skip;
+            if (diff) {
+                const size_t bit = (idx << 3) + bitmap_detail::ctz(diff);
+                return bit < bit_count_ ? bit : npos;
+            }
+        }
+        return npos;
+    }
+
+    uint8_t *data_;
+    size_t bit_count_;
+};
+
+}  // namespace osf
+
+#endif
@@ -58,6 +58,9 @@ const static uint8_t bit_totals[256] = { B6(0), B6(1), B6(1), B6(2) };
 // A place to generalize the creation process and setup
 bitmap_t *bitmap_initialize(size_t n_bits, BITMAP_FLAGS flags);
 
+// Shared guts of ffs/ffz, finds the first bit that doesn't match the skip byte's bits
+size_t bitmap_find_first(const bitmap_t *const bitmap, const uint8_t skip);
+
 void bitmap_set(bitmap_t *const bitmap, const size_t bit) {
     bitmap->data[bit >> 3] |= mask[bit & 0x07];
 }
@@ -82,18 +85,14 @@ void bitmap_invert(bitmap_t *const bitmap) {
 
 size_t bitmap_ffs(const bitmap_t *const bitmap) {
     if (bitmap) {
-        size_t result = 0;
-        for (; result < bitmap->bit_count && !bitmap_test(bitmap, result); ++result) {}
-        return (result == bitmap->bit_count ? SIZE_MAX : result);
+        return bitmap_find_first(bitmap, 0x00);
     }
     return SIZE_MAX;
 }
 
 size_t bitmap_ffz(const bitmap_t *const bitmap) {
     if (bitmap) {
-        size_t result = 0;
-        for (; result < bitmap->bit_count && bitmap_test(bitmap, result); ++result) {}
-        return (result == bitmap->bit_count ? SIZE_MAX : result);
+        return bitmap_find_first(bitmap, 0xFF);
     }
     return SIZE_MAX;
 }
@@ -216,4 +215,116 @@ bitmap_t *bitmap_initialize(size_t n_bits, BITMAP_FLAGS flags) {
         }
     }
     return NULL;
-}
\ No newline at end of file
+}
+
+
+// FFS/FFZ spend nearly all their time walking over bytes that are all 0x00 (ffs) or all 0xFF (ffz)
+// So find the first byte that ISN'T the skip byte as fast as we can, then deal with the bits in it.
+// Runs of uniform bytes get eaten 8 at a time, or 32/64 at a time if the CPU has SSE2/AVX2.
+// (Same trick memchr uses, just looking for the opposite thing)
+// Kernels all return the index of the first non-skip byte, or byte_count if there isn't one.
+
+// Define BITMAP_NO_SIMD to stick to the portable kernel
+#if !defined(BITMAP_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define BITMAP_SIMD_X86
+    #include <immintrin.h>
+#endif
+
+static size_t bitmap_skip_uniform_generic(const uint8_t *const data, const size_t byte_count, const uint8_t skip) {
+    uint64_t skip_chunk;
+    memset(&skip_chunk, skip, sizeof(skip_chunk));
+    size_t idx = 0;
+    // memcpy is the only legal way to do an unaligned load, it turns into a mov anyway
+    for (uint64_t chunk; idx + sizeof(uint64_t) <= byte_count; idx += sizeof(uint64_t)) {
+        memcpy(&chunk, data + idx, sizeof(chunk));
+        if (chunk != skip_chunk) {
+            break;
+        }
+    }
+    for (; idx < byte_count && data[idx] == skip; ++idx) {}
+    return idx;
+}
+
+#ifdef BITMAP_SIMD_X86
+
+__attribute__((target("sse2")))
+static size_t bitmap_skip_uniform_sse2(const uint8_t *const data, const size_t byte_count, const uint8_t skip) {
+    const __m128i skip_vec = _mm_set1_epi8((char) skip);
+    size_t idx = 0;
+    for (; idx + 16 <= byte_count; idx += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)(data + idx));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, skip_vec)) != 0xFFFF) {
+            break;
+        }
+    }
+    // found the chunk (or hit the tail), the generic one can pin down the byte
+    return idx + bitmap_skip_uniform_generic(data + idx, byte_count - idx, skip);
+}
+
+__attribute__((target("avx2")))
+static size_t bitmap_skip_uniform_avx2(const uint8_t *const data, const size_t byte_count, const uint8_t skip) {
+    const __m256i skip_vec = _mm256_set1_epi8((char) skip);
+    size_t idx = 0;
+    // Two loads per loop, XOR against the skip pattern and OR them so there's only one test per 64 bytes
+    for (; idx + 64 <= byte_count; idx += 64) {
+        const __m256i chunk_a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(data + idx)), skip_vec);
+        const __m256i chunk_b = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(data + idx + 32)), skip_vec);
+        if (!_mm256_testz_si256(_mm256_or_si256(chunk_a, chunk_b), _mm256_or_si256(chunk_a, chunk_b))) {
+            break;
+        }
+    }
+    for (; idx + 32 <= byte_count; idx += 32) {
+        const __m256i chunk = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(data + idx)), skip_vec);
+        if (!_mm256_testz_si256(chunk, chunk)) {
+            break;
+        }
+    }
+    return idx + bitmap_skip_uniform_generic(data + idx, byte_count - idx, skip);
+}
+
+static size_t bitmap_skip_uniform_resolve(const uint8_t *const data, const size_t byte_count, const uint8_t skip);
+
+// Starts out pointing at the resolver, which swaps itself out on first use
+// Several threads can resolve at once, so it's only touched through relaxed atomics
+// (they all store the same kernel, and nothing else hangs off the pointer to need ordering)
+static size_t (*bitmap_skip_uniform_kernel)(const uint8_t *const, const size_t, const uint8_t) =
+    &bitmap_skip_uniform_resolve;
+
+static size_t bitmap_skip_uniform_resolve(const uint8_t *const data, const size_t byte_count, const uint8_t skip) {
+    size_t (*kernel)(const uint8_t *const, const size_t, const uint8_t) = &bitmap_skip_uniform_generic;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernel = &bitmap_skip_uniform_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        kernel = &bitmap_skip_uniform_sse2;
+    }
+    __atomic_store_n(&bitmap_skip_uniform_kernel, kernel, __ATOMIC_RELAXED);
+    return kernel(data, byte_count, skip);
+}
+
+static size_t bitmap_skip_uniform(const uint8_t *const data, const size_t byte_count, const uint8_t skip) {
+    return __atomic_load_n(&bitmap_skip_uniform_kernel, __ATOMIC_RELAXED)(data, byte_count, skip);
+}
+
+#else
+
+#define bitmap_skip_uniform bitmap_skip_uniform_generic
+
+#endif
+
+size_t bitmap_find_first(const bitmap_t *const bitmap, const uint8_t skip) {
+    const size_t byte = bitmap_skip_uniform(bitmap->data, bitmap->byte_count, skip);
+    if (byte < bitmap->byte_count) {
+        // the bits that differ from the skip pattern are the ones we're after, take the lowest
+        const uint8_t diff = bitmap->data[byte] ^ skip;
+        size_t bit = 0;
+        for (; !(diff & mask[bit]); ++bit) {}
+        bit += byte << 3;
+        // Leftover bits are undetermined, so a hit past bit_count is no hit at all
+        // (and since this was the first differing byte, there's nothing earlier to find)
+        if (bit < bitmap->bit_count) {
+            return bit;
+        }
+    }
+    return SIZE_MAX;
+}
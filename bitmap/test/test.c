@@ -556,6 +556,67 @@ void bitmap_test_b() {
     assert(bitmap_ffz(bitmap_A) == 57);
 
     bitmap_destroy(bitmap_A);
+
+    // Long runs, so the chunked/SIMD skipping actually kicks in
+    // Odd bit count so the tail handling gets a workout too
+    const size_t long_bit_count = 4096 + 200 + 5;
+    bitmap_A = bitmap_create(long_bit_count);
+    assert(bitmap_A);
+
+    assert(bitmap_ffs(bitmap_A) == SIZE_MAX);
+    assert(bitmap_ffz(bitmap_A) == 0);
+
+    // hole/hit at every position, past every chunk boundary
+    bitmap_format(bitmap_A, 0xFF);
+    assert(bitmap_ffz(bitmap_A) == SIZE_MAX);
+    for (size_t i = 0; i < long_bit_count; ++i) {
+        bitmap_reset(bitmap_A, i);
+        assert(bitmap_ffz(bitmap_A) == i);
+        bitmap_set(bitmap_A, i);
+    }
+
+    bitmap_format(bitmap_A, 0x00);
+    for (size_t i = 0; i < long_bit_count; ++i) {
+        bitmap_set(bitmap_A, i);
+        assert(bitmap_ffs(bitmap_A) == i);
+        bitmap_reset(bitmap_A, i);
+    }
+
+    // garbage past the end of the bitmap doesn't count
+    bitmap_A->data[bitmap_A->byte_count - 1] = 0xE0;
+    assert(bitmap_ffs(bitmap_A) == SIZE_MAX);
+    bitmap_format(bitmap_A, 0xFF);
+    bitmap_A->data[bitmap_A->byte_count - 1] = 0x1F;
+    assert(bitmap_ffz(bitmap_A) == SIZE_MAX);
+
+    bitmap_destroy(bitmap_A);
+
+    // ffs/ffz only ever reach whichever skip kernel this CPU resolves to, so hit all of them directly
+    // Lengths past a few 16/32/64 byte chunks, a hole at every position (and none), off by one so loads are unaligned
+    // The SIMD ones only exist on x86 without BITMAP_NO_SIMD, and AVX2 needs the CPU for it
+#ifdef BITMAP_SIMD_X86
+    __builtin_cpu_init();
+    const bool have_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    uint8_t skip_data[1 + 200];
+    for (int skip_idx = 0; skip_idx < 2; ++skip_idx) {
+        const uint8_t skip = skip_idx ? 0xFF : 0x00;
+        for (size_t length = 0; length <= 200; ++length) {
+            for (size_t hole = 0; hole <= length; ++hole) {
+                memset(skip_data, skip, sizeof(skip_data));
+                if (hole < length) {
+                    skip_data[1 + hole] = skip ^ 0x10;
+                }
+                assert(bitmap_skip_uniform_generic(skip_data + 1, length, skip) == hole);
+#ifdef BITMAP_SIMD_X86
+                assert(bitmap_skip_uniform_sse2(skip_data + 1, length, skip) == hole);
+                if (have_avx2) {
+                    assert(bitmap_skip_uniform_avx2(skip_data + 1, length, skip) == hole);
+                }
+#endif
+            }
+        }
+    }
 }
 
 void bitmap_test_c() {
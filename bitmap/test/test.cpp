@@ -0,0 +1,204 @@
+#include "../include/bitmap.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/*
+    template <size_t N, typename Word> class bitmap;
+
+    1. Geometry is constexpr (word_count, get_bits, get_bytes)
+    2. Set/reset/test/flip, every bit, across word boundaries
+    3. FFS/FFZ, empty, full, arbitrary, padding bits never reported
+    4. next_set/next_zero resume, narrow (uint8_t, uint16_t) words against a bit by bit scan
+    5. invert/format keep the tail clean, total_set
+    6. for_each visits every set bit in order
+
+    class bitmap_view;
+
+    7. View over a bitmap_t agrees with the C library for set/test/ffs/ffz/total_set
+    8. Changes through the view show up in the bitmap_t
+    9. Weird bit count, bits past the count are ignored
+*/
+
+void bitmap_template_tests();
+
+template <typename Word>
+void bitmap_narrow_word_tests();
+
+void bitmap_view_tests();
+
+int main() {
+    bitmap_template_tests();
+
+    bitmap_narrow_word_tests<uint8_t>();
+
+    bitmap_narrow_word_tests<uint16_t>();
+
+    bitmap_view_tests();
+
+    puts("TESTS PASSED");
+}
+
+void bitmap_template_tests() {
+    // 1
+    static_assert(osf::bitmap<58, uint8_t>::word_count == 8, "58 bits is 8 bytes");
+    static_assert(osf::bitmap<64, uint64_t>::word_count == 1, "64 bits is 1 word");
+    static_assert(osf::bitmap<65, uint64_t>::word_count == 2, "65 bits is 2 words");
+    static_assert(osf::bitmap<65, uint32_t>::get_bytes() == 12, "65 bits is 3 uint32s");
+    static_assert(osf::bitmap<100>::get_bits() == 100, "that's how many we asked for");
+
+    osf::bitmap<130, uint32_t> bitmap_A;
+
+    // 3
+    assert(bitmap_A.ffs() == SIZE_MAX);
+    assert(bitmap_A.ffz() == 0);
+    assert(bitmap_A.total_set() == 0);
+
+    // 2
+    for (size_t i = 0; i < 130; ++i) {
+        bitmap_A.set(i);
+        assert(bitmap_A.test(i));
+        assert(bitmap_A.total_set() == i + 1);
+        assert(bitmap_A.ffz() == (i == 129 ? SIZE_MAX : i + 1));
+    }
+    assert(bitmap_A.ffs() == 0);
+
+    for (size_t i = 0; i < 130; ++i) {
+        bitmap_A.reset(i);
+        assert(!bitmap_A.test(i));
+        assert(bitmap_A.ffs() == (i == 129 ? SIZE_MAX : i + 1));
+    }
+
+    bitmap_A.flip(97);
+    assert(bitmap_A.test(97));
+    assert(bitmap_A.ffs() == 97);
+    bitmap_A.flip(97);
+    assert(!bitmap_A.test(97));
+
+    // 4
+    bitmap_A.set(3);
+    bitmap_A.set(31);
+    bitmap_A.set(32);
+    bitmap_A.set(129);
+    assert(bitmap_A.next_set(0) == 3);
+    assert(bitmap_A.next_set(4) == 31);
+    assert(bitmap_A.next_set(32) == 32);
+    assert(bitmap_A.next_set(33) == 129);
+    assert(bitmap_A.next_set(130) == SIZE_MAX);
+    assert(bitmap_A.next_zero(3) == 4);
+    assert(bitmap_A.next_zero(31) == 33);
+    assert(bitmap_A.next_zero(129) == SIZE_MAX);
+
+    // 6
+    std::vector<size_t> visited;
+    bitmap_A.for_each([&visited](size_t bit) { visited.push_back(bit); });
+    assert(visited.size() == 4);
+    assert(visited[0] == 3 && visited[1] == 31 && visited[2] == 32 && visited[3] == 129);
+
+    // 5
+    bitmap_A.invert();
+    assert(bitmap_A.total_set() == 126);
+    assert(bitmap_A.ffz() == 3);
+    assert(bitmap_A.data()[4] == 0x01); // bit 128 set, 129 cleared, padding cleared
+
+    bitmap_A.format(~0u);
+    assert(bitmap_A.total_set() == 130);
+    assert(bitmap_A.ffz() == SIZE_MAX);
+
+    bitmap_A.format(0);
+    assert(bitmap_A.total_set() == 0);
+    assert(bitmap_A.ffs() == SIZE_MAX);
+}
+
+template <typename Word>
+void bitmap_narrow_word_tests() {
+    // 4
+    // narrow words get promoted to int on the way through ~ and <<, every start bit in every word
+    osf::bitmap<100, Word> bitmap_A;
+    const size_t set_bits[5] = {5, 7, 8, 31, 97};
+    for (const size_t bit : set_bits) {
+        bitmap_A.set(bit);
+    }
+    for (size_t start = 0; start <= 100; ++start) {
+        size_t expected_set = SIZE_MAX, expected_zero = SIZE_MAX;
+        for (size_t bit = 100; bit-- > start;) {
+            if (bitmap_A.test(bit)) {
+                expected_set = bit;
+            } else {
+                expected_zero = bit;
+            }
+        }
+        assert(bitmap_A.next_set(start) == expected_set);
+        assert(bitmap_A.next_zero(start) == expected_zero);
+    }
+    assert(bitmap_A.next_set(5) == 5);
+    assert(bitmap_A.next_set(9) == 31);
+    assert(bitmap_A.next_zero(7) == 9);
+
+    bitmap_A.format(Word(~Word(0)));
+    assert(bitmap_A.next_zero(0) == SIZE_MAX);
+    assert(bitmap_A.next_set(99) == 99);
+    bitmap_A.reset(99);
+    assert(bitmap_A.next_zero(50) == 99);
+}
+
+void bitmap_view_tests() {
+    // 58 bits = 7.2 bytes, the C tests' favorite
+    const size_t test_bit_count = 58;
+    bitmap_t *bitmap_A = bitmap_create(test_bit_count);
+    assert(bitmap_A);
+
+    osf::bitmap_view view(bitmap_A);
+    assert(view.get_bits() == test_bit_count);
+    assert(view.get_bytes() == bitmap_get_bytes(bitmap_A));
+    assert(view.data() == bitmap_export(bitmap_A));
+
+    // 7
+    assert(view.ffs() == bitmap_ffs(bitmap_A));
+    assert(view.ffz() == bitmap_ffz(bitmap_A));
+
+    for (size_t i = 0; i < test_bit_count; i += 3) {
+        bitmap_set(bitmap_A, i);
+    }
+    for (size_t i = 0; i < test_bit_count; ++i) {
+        assert(view.test(i) == bitmap_test(bitmap_A, i));
+    }
+    assert(view.total_set() == bitmap_total_set(bitmap_A));
+    assert(view.ffz() == bitmap_ffz(bitmap_A));
+
+    size_t visited = 0;
+    view.for_each([&visited, bitmap_A](size_t bit) {
+        assert(bitmap_test(bitmap_A, bit));
+        ++visited;
+    });
+    assert(visited == bitmap_total_set(bitmap_A));
+
+    // 8
+    view.flip(1);
+    assert(bitmap_test(bitmap_A, 1));
+    view.reset(0);
+    assert(!bitmap_test(bitmap_A, 0));
+    assert(view.ffs() == 1);
+    assert(bitmap_ffs(bitmap_A) == 1);
+
+    // 9
+    bitmap_format(bitmap_A, 0xFF);
+    assert(view.ffz() == SIZE_MAX);
+    assert(view.total_set() == test_bit_count);
+    bitmap_reset(bitmap_A, 57);
+    assert(view.ffz() == 57);
+    assert(view.ffz() == bitmap_ffz(bitmap_A));
+
+    bitmap_format(bitmap_A, 0x00);
+    // poke the undetermined bits past the end, the view shouldn't see them
+    view.data()[7] = 0xFC;
+    assert(view.ffs() == SIZE_MAX);
+    assert(view.total_set() == 0);
+    visited = 0;
+    view.for_each([&visited](size_t) { ++visited; });
+    assert(visited == 0);
+
+    bitmap_destroy(bitmap_A);
+}
@@ -46,7 +46,7 @@ int main(int argc, char *argv[]) {
             }
             delete[] data;
             out.close();
-        } catch (std::exception e) {
+        } catch (std::exception &e) {
             std::cerr << "Generation failed because: " << e.what() << std::endl;
             return -1;
         }
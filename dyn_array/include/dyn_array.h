@@ -7,10 +7,42 @@
 #include <string.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct dyn_array dyn_array_t;
-// Next version, push/pop_N_back/front for bulk loading
-// Erase_n
-// etc
+
+// How capacity grows when the array runs out of room
+// DOUBLE: capacity doubles (the default, and how it's always been)
+// HALF: capacity grows by half (1.5x), trades more reallocs for less slack
+// EXACT: capacity grows to exactly what's needed, every growing insert reallocates
+typedef enum {DYN_GROW_DOUBLE = 0x00, DYN_GROW_HALF = 0x01, DYN_GROW_EXACT = 0x02} DYN_GROWTH_POLICY;
+
+// What kind of key dyn_array_sort_radix is looking at
+// UNSIGNED: unsigned integer (the default)
+// SIGNED: two's complement signed integer
+// FLOAT: float (4 byte keys) or double (8 byte keys)
+// DESCENDING: biggest first, can be combined with any of the above
+typedef enum {DYN_RADIX_UNSIGNED = 0x00, DYN_RADIX_SIGNED = 0x01, DYN_RADIX_FLOAT = 0x02, DYN_RADIX_DESCENDING = 0x04} DYN_RADIX_FLAGS;
+
+// How dyn_array_map treats the file's contents
+// READ_ONLY: the array can't be changed at all, every function that would change it fails (the default)
+// PRIVATE: copy on write, change anything you want, the file never sees it
+typedef enum {DYN_MAP_READ_ONLY = 0x00, DYN_MAP_PRIVATE = 0x01} DYN_MAP_FLAGS;
+
+// Where a dyn_array gets its memory (see the allocator notes below)
+// alloc: required, returns bytes of storage (malloc aligned) or NULL
+// realloc: optional, resizes ptr from old_bytes to new_bytes, NULL on failure (ptr stays good)
+//          (NULL means alloc a new block, copy, and free the old one)
+// free: optional, gets back ptr and the size it was allocated at (NULL means never free, arena style)
+// context: handed to every call, untouched by us
+typedef struct {
+    void *(*alloc)(void *context, size_t bytes);
+    void *(*realloc)(void *context, void *ptr, size_t old_bytes, size_t new_bytes);
+    void (*free)(void *context, void *ptr, size_t bytes);
+    void *context;
+} dyn_allocator_t;
 
 /*
 	Destructor notes!
@@ -40,6 +72,80 @@ typedef struct dyn_array dyn_array_t;
 ///
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *));
 
+/*
+	Allocator notes!
+
+	dyn_array_create uses malloc/realloc/free.
+	  (On Linux, blocks past DYN_MMAP_THRESHOLD bytes, 64MB unless the library was built with something else,
+	  get their own anonymous mapping instead and grow with mremap, so doubling a huge array doesn't copy it)
+	dyn_array_create_with_allocator lets you hand over your own (an arena, a pool, aligned storage...)
+
+	The allocator is copied in at creation and cannot be changed afterwards.
+	Everything the array owns comes from it: the dyn_array_t itself, the contents, and the sort scratch.
+	Short-lived temporaries (linearize's parking spot, parallel reduce accumulators) still use malloc.
+
+	With no free callback nothing is ever given back, so the whole array can be dropped
+	  by resetting the arena. Destructors only run if you dyn_array_destroy (or clear/erase), though.
+
+	Whatever context points to has to outlive the array.
+*/
+
+///
+/// Creates a new dynamic array that gets its memory from the given allocator
+/// Same as dyn_array_create otherwise
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \param allocator The allocator to use (copied), NULL for malloc/realloc/free
+/// \return new dynamic array pointer, NULL on error
+///
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+                                             void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+
+/*
+	Inline notes!
+
+	dyn_array_init_inline builds the dyn_array_t inside a buffer you hand it (on the stack, in a struct, wherever)
+	  and keeps the objects in whatever's left of the buffer after it.
+	No allocations at all until it outgrows that, then the contents move out to the heap like any other array.
+	shrink_to_fit brings them back in if they fit again.
+
+	DYN_ARRAY_INLINE_BUFFER declares a buffer that's big enough and aligned right.
+	ex: DYN_ARRAY_INLINE_BUFFER(buffer, 8, sizeof(int));
+	    dyn_array_t *numbers = dyn_array_init_inline(&buffer, sizeof(buffer), sizeof(int), NULL);
+
+	Still dyn_array_destroy it when you're done (destructors, anything that spilled out, the sort scratch)
+	  but the buffer itself is yours, we never free it.
+	The buffer can't be moved or copied while the array's alive, the array lives IN it.
+*/
+
+// Bytes at the start of an inline buffer that go to the dyn_array_t itself, the rest holds objects
+#define DYN_ARRAY_INLINE_OVERHEAD (24 * sizeof(void *))
+
+// Bytes an inline buffer needs to hold count objects of data_type_size
+#define DYN_ARRAY_INLINE_SIZE(count, data_type_size) (DYN_ARRAY_INLINE_OVERHEAD + (count) * (data_type_size))
+
+// Declares an inline buffer called name with room for count objects of data_type_size
+#define DYN_ARRAY_INLINE_BUFFER(name, count, data_type_size) \
+    union {                                                  \
+        uint8_t bytes[DYN_ARRAY_INLINE_SIZE(count, data_type_size)]; \
+        long double align_float;                             \
+        uint64_t align_int;                                  \
+        void *align_ptr;                                     \
+    } name
+
+///
+/// Creates a new dynamic array inside the given buffer, objects are kept in the buffer until they don't fit
+/// Same as dyn_array_create otherwise (spilled contents come from malloc)
+/// \param buffer Where the array goes, has to be pointer aligned (DYN_ARRAY_INLINE_BUFFER is)
+/// \param buffer_size Size of the buffer, at least DYN_ARRAY_INLINE_SIZE(1, data_type_size)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \return new dynamic array pointer (which points into buffer), NULL on error
+///
+dyn_array_t *dyn_array_init_inline(void *const buffer, const size_t buffer_size, const size_t data_type_size,
+                                   void (*destruct_func)(void *));
+
 ///
 /// Creates a new dynamic array from a given array
 /// (Given pointer can be freed after import, we copy the data)
@@ -54,6 +160,7 @@ dyn_array_t *dyn_array_import(const void *const data, const size_t count, const
 ///
 /// Returns an internal pointer to the data array for export
 /// Since this pointer is internal, it may be invalidated by insertions that trigger reallocation
+/// (In ring mode, the contents get rearranged into one block first, so other internal pointers are invalidated too)
 /// \param dyn_array The dynamic array to export
 /// \return Pointer to dynamic array contents, NULL on error
 ///
@@ -71,6 +178,7 @@ void dyn_array_destroy(dyn_array_t *const dyn_array);
 
 // Prefer the X_back functions if you use a lot of push/pop operations
 // because, duh, it's an array and arrays don't handle front operations well
+// ...unless you turn on ring mode (see dyn_array_set_ring_mode), then front and back are both cheap
 
 // All insertions/extractions are via memcpy, so giving us pointers overlapping ourselves is UNDEFINED
 // The logic behind this is that you shouldn't be giving us an internal pointer that overlaps because that's weird
@@ -145,6 +253,7 @@ bool dyn_array_extract_back(dyn_array_t *const dyn_array, void *const object);
 ///
 /// Returns a pointer to the desired object in the array
 /// Pointer may be invalidated if the container increases in size
+/// In ring mode, objects are only contiguous up to the wrap, so don't walk past this pointer
 /// \param dyn_array the dynamic array
 /// \param index the index of the object to retrieve
 /// \return pointer to the requested object, NULL on error
@@ -181,6 +290,119 @@ bool dyn_array_erase(dyn_array_t *const dyn_array, const size_t index);
 bool dyn_array_extract(dyn_array_t *const dyn_array, const size_t index,
                            void *const object);
 
+///
+/// Removes and optionally destructs the object at the given index, the back object takes its place
+/// Constant time no matter where index is, but the order of the objects isn't kept
+/// \param dyn_array the dynamic array
+/// \param index index of the object to be erased
+/// \return bool representing success of the operation
+///
+bool dyn_array_erase_unordered(dyn_array_t *const dyn_array, const size_t index);
+
+///
+/// Removes the object at the given index and places it at the desired location, the back object takes its place
+/// Does not destruct the object since it is returned to the user
+/// Constant time no matter where index is, but the order of the objects isn't kept
+/// \param dyn_array the dynamic array
+/// \param index the index of the object to extract
+/// \param object destination for extracted object
+/// \return bool representing success of the operation
+///
+bool dyn_array_extract_unordered(dyn_array_t *const dyn_array, const size_t index, void *const object);
+
+
+
+// Bulk versions of the above. Same rules, just count objects at a time
+// (one capacity check, one memmove, one memcpy, no matter how many objects)
+// objects points to count contiguous objects. A count of zero is an error, same as a NULL pointer.
+
+///
+/// Copies the given objects and places them at the front of the array, in order
+/// \param dyn_array the dynamic array
+/// \param objects the objects to insert
+/// \param count number of objects to insert
+/// \return bool representing success of the operation
+///
+bool dyn_array_push_front_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+
+///
+/// Removes and optionally destructs count objects from the front of the array
+/// \param dyn_array the dynamic array
+/// \param count number of objects to remove
+/// \return bool representing success of the operation (false if there aren't count objects)
+///
+bool dyn_array_pop_front_n(dyn_array_t *const dyn_array, const size_t count);
+
+///
+/// Copies the given objects and places them at the back of the array, in order
+/// \param dyn_array the dynamic array
+/// \param objects the objects to insert
+/// \param count number of objects to insert
+/// \return bool representing success of the operation
+///
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+
+///
+/// Removes and optionally destructs count objects from the back of the array
+/// \param dyn_array the dynamic array
+/// \param count number of objects to remove
+/// \return bool representing success of the operation (false if there aren't count objects)
+///
+bool dyn_array_pop_back_n(dyn_array_t *const dyn_array, const size_t count);
+
+///
+/// Inserts the given objects starting at the given index, moving any contents at index and beyond down count
+/// \param dyn_array the dynamic array
+/// \param index the position to insert the first object at
+/// \param objects the objects to insert
+/// \param count number of objects to insert
+/// \return bool representing success of the operation
+///
+bool dyn_array_insert_n(dyn_array_t *const dyn_array, const size_t index,
+                        const void *const objects, const size_t count);
+
+///
+/// Removes and optionally destructs count objects starting at the given index
+/// \param dyn_array the dynamic array
+/// \param index index of the first object to be erased
+/// \param count number of objects to erase
+/// \return bool representing success of the operation
+///
+bool dyn_array_erase_n(dyn_array_t *const dyn_array, const size_t index, const size_t count);
+
+///
+/// Removes count objects starting at the given index and places them at the desired location
+/// Does not destruct the objects since they are returned to the user
+/// \param dyn_array the dynamic array
+/// \param index the index of the first object to extract
+/// \param objects destination for extracted objects (room for count objects)
+/// \param count number of objects to extract
+/// \return bool representing success of the operation
+///
+bool dyn_array_extract_n(dyn_array_t *const dyn_array, const size_t index,
+                         void *const objects, const size_t count);
+
+///
+/// Copies the contents of one dynamic array to the back of another
+/// Copies are shallow, so if both arrays have destructors, something's getting destructed twice
+/// Appending an empty array (or an array to itself) is fine
+/// \param dst the dynamic array to append to
+/// \param src the dynamic array to copy from (data sizes must match)
+/// \return bool representing success of the operation
+///
+bool dyn_array_append(dyn_array_t *const dst, const dyn_array_t *const src);
+
+///
+/// Copies count objects starting at first from one dynamic array to the back of another
+/// \param dst the dynamic array to append to
+/// \param src the dynamic array to copy from (data sizes must match, can be dst)
+/// \param first index of the first object to copy
+/// \param count number of objects to copy
+/// \return bool representing success of the operation
+///
+bool dyn_array_append_range(dyn_array_t *const dst, const dyn_array_t *const src,
+                            const size_t first, const size_t count);
+
 
 ///
 /// Removes and optionally destructs all array elements
@@ -216,18 +438,131 @@ size_t dyn_array_capacity(const dyn_array_t *const dyn_array);
 ///
 size_t dyn_array_data_size(const dyn_array_t *const dyn_array);
 
+///
+/// Makes sure the array can hold at least capacity objects without reallocating
+/// Never shrinks the array, and the capacity you get is exactly what you asked for
+/// \param dyn_array the dynamic array
+/// \param capacity the number of objects to make room for
+/// \return bool representing success of the operation
+///
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity);
+
+///
+/// Releases unused capacity, so capacity matches size (room for one object is kept if empty)
+/// The next growth after this starts over from the smallest capacity and follows the growth policy
+/// Pointers into the array may be invalidated
+/// \param dyn_array the dynamic array
+/// \return bool representing success of the operation
+///
+bool dyn_array_shrink_to_fit(dyn_array_t *const dyn_array);
+
+///
+/// Sets how the array grows when it runs out of room
+/// \param dyn_array the dynamic array
+/// \param policy the growth policy
+/// \param max_step the most objects a single growth may add (0 for no limit, ignored by DYN_GROW_EXACT)
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_growth(dyn_array_t *const dyn_array, const DYN_GROWTH_POLICY policy, const size_t max_step);
+
+///
+/// Turns ring (circular buffer) mode on or off
+/// In ring mode, push/pop/extract at the front AND the back are O(1) (amortized, for the pushes),
+///  so it's an actual deque/FIFO queue. Everything else works the same and index 0 is still the front.
+/// The catch: contents may wrap around the end of the internal array. Operations that need it in one
+///  piece (export, sort, inserting/erasing in the middle) will straighten it out first, which is O(n)
+/// Turning it off straightens it out for good.
+/// \param dyn_array the dynamic array
+/// \param enable true for ring mode, false for a plain array
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_ring_mode(dyn_array_t *const dyn_array, const bool enable);
+
 ///
 /// Sorts the array according to the given comparator function
 /// compare(x,y) < 0 iff x < y
 /// compare(x,y) = 0 iff x == y
 /// compare(x,y) > 0 iff y > x
-/// Sort is not guarenteed to be stable
+/// Sort is not guarenteed to be stable (use dyn_array_sort_stable for that)
+/// It's a pattern-defeating quicksort, n log n worst case, linear on sorted/reversed/all-equal input,
+///  with swaps specialized for 4, 8, 16 and 32 byte objects
 /// \param dyn_array the dynamic array
 /// \param compare the comparison function
 /// \return bool representing success of the operation
 ///
 bool dyn_array_sort(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *));
 
+///
+/// Sorts the array according to the given comparator function, equal objects keep their order
+/// Merge sort, needs a scratch buffer of half the array. The buffer is kept for the next sort
+///  (shrink_to_fit or destroy will free it)
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function
+/// \return bool representing success of the operation (false if the scratch buffer couldn't be allocated)
+///
+bool dyn_array_sort_stable(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *));
+
+///
+/// Sorts the array according to the given comparator function, using up to nthreads threads
+/// Each thread sorts a chunk, then the chunks get merged (in parallel too). Not stable.
+/// Small arrays (or nthreads < 2) just get dyn_array_sort, threads aren't free. So does running
+///  out of memory for the scratch buffer (the size of the array, kept for the next sort)
+/// The comparator gets called from multiple threads at once, so it had better not have side effects
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function
+/// \param nthreads the most threads to use, including the calling thread
+/// \return bool representing success of the operation
+///
+bool dyn_array_sort_parallel(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *),
+                             const size_t nthreads);
+
+///
+/// Sorts the array by an integer (or float) key stored inside each object, no comparator needed
+/// LSD radix sort, linear time and stable. Needs a scratch buffer the size of the array,
+///  kept for the next sort same as dyn_array_sort_stable
+/// Keys are read in native byte order
+/// \param dyn_array the dynamic array
+/// \param key_offset where the key starts in each object, in bytes
+/// \param key_width size of the key in bytes, 1, 2, 4 or 8 (4 or 8 for floats)
+/// \param flags what kind of key it is, and which direction to sort
+/// \return bool representing success of the operation (false on a bad key, or if the scratch buffer couldn't be allocated)
+///
+bool dyn_array_sort_radix(dyn_array_t *const dyn_array, const size_t key_offset, const size_t key_width,
+                          const DYN_RADIX_FLAGS flags);
+
+///
+/// Puts the object that would be at index nth after a sort there, with nothing bigger in front of it
+///  and nothing smaller after it. The rest are in no particular order
+/// Introselect, linear time on average (never worse than n log n). The median's nth = size / 2
+/// \param dyn_array the dynamic array
+/// \param nth the index to fill
+/// \param compare the comparison function
+/// \return bool representing success of the operation (false if nth is out of range)
+///
+bool dyn_array_nth_element(dyn_array_t *const dyn_array, const size_t nth, int (*compare)(const void *, const void *));
+
+///
+/// Sorts just the k smallest objects into the front of the array, the rest are in no particular order
+/// nth_element then a sort of the front, n + k log k. k past the size sorts the whole thing
+/// \param dyn_array the dynamic array
+/// \param k how many objects to sort into place
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_partial_sort(dyn_array_t *const dyn_array, const size_t k, int (*compare)(const void *, const void *));
+
+///
+/// Copies the k biggest objects (by compare, the same way the heap functions see the top) out, biggest first
+/// Doesn't change the array at all. One pass with a k sized heap kept in objects, n log k at worst
+/// \param dyn_array the dynamic array
+/// \param k how many objects to copy out
+/// \param objects destination for the objects, room for k of them (or size, if that's smaller)
+/// \param compare the comparison function
+/// \return the number of objects copied out, the smaller of k and size (0 on error)
+///
+size_t dyn_array_top_k(const dyn_array_t *const dyn_array, const size_t k, void *const objects,
+                       int (*compare)(const void *, const void *));
+
 
 ///
 /// Inserts the given object into the correct sorted position
@@ -242,6 +577,270 @@ bool dyn_array_sort(dyn_array_t *const dyn_array, int (*compare)(const void *, c
 bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const object,
                                  int (*compare)(const void *const, const void *const));
 
+///
+/// Inserts the given object into the correct sorted position, after any objects equal to it
+/// (so equal objects stay in the order they were inserted)
+/// Note: calling this on an unsorted array will insert it... somewhere
+/// \param dyn_array the dynamic array
+/// \param object the object to insert
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_insert_sorted_stable(dyn_array_t *const dyn_array, const void *const object,
+                                    int (*compare)(const void *const, const void *const));
+
+// Binary searches! All of these require the array to be sorted by the given comparator.
+// compare is always called as compare(object, array_element)
+
+///
+/// Finds the first position in a sorted array whose object is not less than the given object
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \return index of the first object >= the given object (size if there isn't one), SIZE_MAX on error
+///
+size_t dyn_array_lower_bound(const dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *const, const void *const));
+
+///
+/// Finds the first position in a sorted array whose object is greater than the given object
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \return index of the first object > the given object (size if there isn't one), SIZE_MAX on error
+///
+size_t dyn_array_upper_bound(const dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *const, const void *const));
+
+///
+/// Finds the range of objects in a sorted array equal to the given object, [first, last)
+/// first == last means there's no match (and that's where it would go)
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \param first destination for the index of the first equal object
+/// \param last destination for the index one past the last equal object
+/// \return bool representing success of the operation
+///
+bool dyn_array_equal_range(const dyn_array_t *const dyn_array, const void *const object,
+                           int (*compare)(const void *const, const void *const),
+                           size_t *const first, size_t *const last);
+
+///
+/// Finds an object in a sorted array equal to the given object
+/// If there are several, you get the first one
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \return pointer to the matching object, NULL on error/not found
+///
+void *dyn_array_bsearch(const dyn_array_t *const dyn_array, const void *const object,
+                        int (*compare)(const void *const, const void *const));
+
+/*
+	Sorted notes!
+
+	The array remembers when it's sorted, and by which comparator.
+	Sorting sets it. Removing objects (pop, erase, extract, prune, clear) keeps it.
+	Inserting keeps it only if the new objects land in order (insert_sorted always does,
+	  push_back of something no smaller than the back does), anything else drops it.
+	Radix sorts, the heap functions and the for_each family (they hand out writable objects) drop it too.
+
+	With it, find/contains/unique are binary searches instead of scans, nth_element/partial_sort/top_k
+	  are nearly free, and sorting again is a single pass to check nothing moved.
+	Writing through a pointer from at/front/back/export isn't something we can see.
+	  If that changes the order, call dyn_array_mark_unsorted (or sort again, it checks before it trusts).
+*/
+
+///
+/// Tests if the array is in order by the given comparator
+/// Free if the array already knows it's sorted that way, a pass over the array otherwise (and then it knows)
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function
+/// \return true if sorted (empty counts), false if not or on error
+///
+bool dyn_array_is_sorted(const dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+
+///
+/// Forgets that the array is sorted, for when you changed objects through a pointer we handed out
+/// \param dyn_array the dynamic array
+///
+void dyn_array_mark_unsorted(dyn_array_t *const dyn_array);
+
+///
+/// Finds the first object equal to the given object
+/// A binary search if the array knows it's sorted by compare, a scan from the front otherwise
+/// compare is called as compare(object, array_element)
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \return index of the first equal object, SIZE_MAX if there isn't one (or on error)
+///
+size_t dyn_array_find(const dyn_array_t *const dyn_array, const void *const object,
+                      int (*compare)(const void *const, const void *const));
+
+///
+/// Tests if the array holds an object equal to the given object (dyn_array_find, but yes or no)
+/// \param dyn_array the dynamic array
+/// \param object the object to search for
+/// \param compare the comparison function
+/// \return true if found, false if not or on error
+///
+bool dyn_array_contains(const dyn_array_t *const dyn_array, const void *const object,
+                        int (*compare)(const void *const, const void *const));
+
+
+// Heaps! A priority queue right in the array, push and pop are O(log n) instead of insert_sorted's O(n)
+// The top (front) is the object that would sort LAST with the given comparator, same as C++'s heaps.
+//  (so for a min-heap, like a scheduler's next event, flip your comparator)
+// Every heap function has to get the same comparator, and the array has to already be a heap
+//  (heapify it first if it isn't). Children of n are n * arity + 1 through n * arity + arity.
+
+///
+/// Sets how many children each heap node has, 2 (the default) or more
+/// 4 is usually quicker for big heaps, the tree is half as tall and siblings share a cache line
+/// Changes the layout! heapify again if the array's already a heap
+/// \param dyn_array the dynamic array
+/// \param arity children per node, 2 through 16
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_heap_arity(dyn_array_t *const dyn_array, const size_t arity);
+
+///
+/// Rearranges the array into a heap, O(n)
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_heapify(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+
+///
+/// Copies the given object into the heap
+/// \param dyn_array the dynamic array
+/// \param object the object to push
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_heap_push(dyn_array_t *const dyn_array, const void *const object,
+                         int (*compare)(const void *const, const void *const));
+
+///
+/// Removes and optionally destructs the top of the heap
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_heap_pop(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+
+///
+/// Removes the top of the heap and copies it to the given location
+/// \param dyn_array the dynamic array
+/// \param object the location to copy the object to
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_heap_extract(dyn_array_t *const dyn_array, void *const object,
+                            int (*compare)(const void *const, const void *const));
+
+///
+/// Returns a pointer to the top of the heap
+/// \param dyn_array the dynamic array
+/// \return pointer to the top object, NULL on error/empty
+///
+void *dyn_array_heap_top(const dyn_array_t *const dyn_array);
+
+///
+/// Puts the object at index back where it belongs after you've changed it (raised or lowered its priority)
+/// \param dyn_array the dynamic array
+/// \param index the index of the changed object
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_heap_update(dyn_array_t *const dyn_array, const size_t index,
+                           int (*compare)(const void *const, const void *const));
+
+///
+/// Removes and optionally destructs every object the predicate returns true for
+/// One pass, and the objects that stay keep their order
+/// \param dyn_array the dynamic array
+/// \param predicate the test, return true to remove the object (arg is passed as parameter 2)
+/// \param arg argument that will be passed to the predicate
+/// \return the number of objects removed, 0 on error
+///
+size_t dyn_array_prune(dyn_array_t *const dyn_array, bool (*predicate)(const void *const, void *), void *arg);
+
+///
+/// Removes and optionally destructs every object equal to the one before it (keeps the first of each run)
+/// On a sorted array that's every duplicate. One pass, and the objects that stay keep their order
+/// If the array knows it's sorted by compare, runs of duplicates are skipped with a binary search
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function, 0 means equal
+/// \return the number of objects removed, 0 on error
+///
+size_t dyn_array_unique(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+
+/*
+	Merge notes!
+
+	merge and the set functions walk two arrays sorted by compare, once, side by side.
+	The result is appended to dst, which grows once up front to the most it could take
+	  (reserve it first and there's no allocation at all).
+	Objects are copied byte for byte, same as append. Careful with destructors.
+	dst can't be a or b. a and b can be the same array.
+
+	Multiset rules, same as the C++ <algorithm> versions:
+	  merge: everything, equal objects from a go before b's (stable)
+	  union: objects in either, an object in both shows up once per pair (a's copy)
+	  intersection: objects in both, once per pair (a's copy)
+	  difference: objects in a without a partner in b
+
+	The output's only in order if a and b were. If they both know they're sorted by compare,
+	  so does dst afterwards (unless it already held something bigger).
+*/
+
+///
+/// Merges two sorted arrays onto the back of dst in linear time
+/// \param dst the destination array
+/// \param a first sorted array
+/// \param b second sorted array
+/// \param compare the comparison function both are sorted by
+/// \return bool representing success of the operation (false on mismatched data sizes, dst being a or b, or no memory)
+///
+bool dyn_array_merge(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                     int (*compare)(const void *const, const void *const));
+
+///
+/// Appends the union of two sorted arrays to dst
+/// \param dst the destination array
+/// \param a first sorted array
+/// \param b second sorted array
+/// \param compare the comparison function both are sorted by
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_union(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                         int (*compare)(const void *const, const void *const));
+
+///
+/// Appends the intersection of two sorted arrays to dst
+/// \param dst the destination array
+/// \param a first sorted array
+/// \param b second sorted array
+/// \param compare the comparison function both are sorted by
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_intersection(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                                int (*compare)(const void *const, const void *const));
+
+///
+/// Appends the objects of sorted array a that aren't in sorted array b to dst
+/// \param dst the destination array
+/// \param a sorted array to take objects from
+/// \param b sorted array of objects to leave out
+/// \param compare the comparison function both are sorted by
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_difference(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                              int (*compare)(const void *const, const void *const));
 
 ///
 /// Applies the given function to every obejct in the array
@@ -252,6 +851,250 @@ bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const obj
 ///
 bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*func)(void * const, void *), void * arg);
 
+///
+/// Applies the given function to every contiguous run of objects in the array, in order
+/// Gets called with a pointer to the first object in the run and how many there are,
+///  so the loop lives in your function and the compiler can actually do something with it
+/// A plain array is one run (split up by max_span), a wrapped ring is two. Nothing gets moved.
+/// \param dyn_array the dynamic array
+/// \param func the function to apply (base of the run, number of objects, arg)
+/// \param arg argument that will be passed to the function (as parameter 3)
+/// \param max_span the most objects to hand out per call (0 for no limit)
+/// \return bool representing success of operation (really just pointer and size checks)
+///
+bool dyn_array_for_each_span(dyn_array_t *const dyn_array, void (*func)(void *const, const size_t, void *), void *arg,
+                             const size_t max_span);
+
+///
+/// Applies the given function to every object in the array, using up to nthreads threads
+/// Each thread gets one contiguous chunk of at least grain objects (chunks start on cache lines
+///  where the layout allows it), so there may be fewer threads than asked for. No order is guaranteed.
+/// The function gets called from multiple threads at once, anything it shares through arg is on you
+/// \param dyn_array the dynamic array
+/// \param func the function to apply
+/// \param arg argument that will be passed to the function (as parameter 2)
+/// \param nthreads the most threads to use, including the calling thread
+/// \param grain the fewest objects worth a thread (0 for a sensible default)
+/// \return bool representing success of operation (really just pointer and size checks)
+///
+bool dyn_array_for_each_parallel(dyn_array_t *const dyn_array, void (*func)(void *const, void *), void *arg,
+                                 const size_t nthreads, const size_t grain);
+
+///
+/// Reduces the array to a single value, using up to nthreads threads
+/// Each thread gets its own accumulator, starting as a copy of identity, and calls
+///  accumulate(accumulator, object, arg) for every object in its chunk. Then the accumulators get
+///  combined into result with combine(result, accumulator, arg), in array order, on the calling thread.
+/// So result should hold the starting value, and combine needs to be associative (not commutative)
+/// \param dyn_array the dynamic array
+/// \param accumulate folds an object into an accumulator
+/// \param combine folds an accumulator into result
+/// \param result starting value in, final value out (accumulator_size bytes)
+/// \param identity value every accumulator starts with, like 0 for sums (accumulator_size bytes)
+/// \param accumulator_size size of an accumulator, in bytes
+/// \param arg argument that will be passed to accumulate and combine (as parameter 3)
+/// \param nthreads the most threads to use, including the calling thread
+/// \param grain the fewest objects worth a thread (0 for a sensible default)
+/// \return bool representing success of operation (false if the accumulators couldn't be allocated)
+///
+bool dyn_array_reduce_parallel(dyn_array_t *const dyn_array, void (*accumulate)(void *const, const void *const, void *),
+                               void (*combine)(void *const, const void *const, void *), void *const result,
+                               const void *const identity, const size_t accumulator_size, void *arg,
+                               const size_t nthreads, const size_t grain);
+
+/*
+	Persistence notes!
+
+	dyn_array_save writes a small header (count, data_size, version) and then the objects, byte for byte.
+	dyn_array_map hands back an array that IS the file, mapped into memory. Nothing gets read or copied up front,
+	  pages come in as you touch them, so a huge lookup table is ready to go immediately.
+
+	Objects are saved as raw bytes. Pointers in them won't mean anything to the next process,
+	  and files only load on the same kind of machine they were saved on.
+
+	Mapped arrays have no destructor.
+	A read-only map can't be changed at all (push, pop, sort, reserve... all fail)
+	  and for_each functions had better not write to the objects either, the pages are read-only.
+	A private map can be changed. Edits only copy the pages they touch, anything that needs more room
+	  copies the contents out to the heap first (once, then it's a normal array).
+	The file can be changed or deleted after mapping without hurting the array, mostly.
+	  (Truncating it out from under a live mapping is a SIGBUS waiting to happen. Don't.)
+*/
+
+///
+/// Writes the array's contents to a file (replacing it), dyn_array_map can load it later
+/// \param dyn_array the dynamic array
+/// \param path the file to write
+/// \return bool representing success of operation (the file may be left half written on failure)
+///
+bool dyn_array_save(const dyn_array_t *const dyn_array, const char *const path);
+
+///
+/// Creates a dynamic array backed directly by a file written by dyn_array_save
+/// \param path the file to map
+/// \param flags DYN_MAP_READ_ONLY or DYN_MAP_PRIVATE
+/// \return new dynamic array pointer, NULL on error (including files that weren't saved by us, or are cut short)
+///
+dyn_array_t *dyn_array_map(const char *const path, const DYN_MAP_FLAGS flags);
+
+/*
+	Segmented notes!
+
+	dyn_segmented_t is an append-mostly array that never moves anything once it's in.
+	Storage is a table of segments that double in size (16, 32, 64... objects),
+	  growing adds a segment instead of reallocating, so:
+	    Pointers from dyn_segmented_at/front/back stay good until that object is popped or cleared.
+	    Growing never copies the contents (the big stall when a huge dyn_array reallocs).
+	    Finding an object is still O(1), just a bit of math on the index.
+
+	The catch: contents aren't one block. Use dyn_segmented_for_each_span to get at them in runs.
+	Only the back end moves (push/pop/extract_back), no inserts or erases in the middle.
+
+	Same destructor rules as dyn_array.
+*/
+
+typedef struct dyn_segmented dyn_segmented_t;
+
+///
+/// Creates a new segmented array of data_type_size-sized objects with optional destructor
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \return new segmented array pointer, NULL on error
+///
+dyn_segmented_t *dyn_segmented_create(const size_t data_type_size, void (*destruct_func)(void *));
+
+///
+/// Segmented array destructor
+/// Applies destructor to all remaining elements
+/// \param segmented The segmented array to destruct
+///
+void dyn_segmented_destroy(dyn_segmented_t *const segmented);
+
+///
+/// Returns a pointer to the object at the specified index
+/// The pointer stays valid until the object is popped, extracted or cleared
+/// \param segmented the segmented array
+/// \param index the index of the object
+/// \return pointer to the object, NULL on error
+///
+void *dyn_segmented_at(const dyn_segmented_t *const segmented, const size_t index);
+
+///
+/// Returns a pointer to the object at the front of the array
+/// \param segmented the segmented array
+/// \return pointer to the front object, NULL on error
+///
+void *dyn_segmented_front(const dyn_segmented_t *const segmented);
+
+///
+/// Returns a pointer to the object at the back of the array
+/// \param segmented the segmented array
+/// \return pointer to the back object, NULL on error
+///
+void *dyn_segmented_back(const dyn_segmented_t *const segmented);
+
+///
+/// Copies the given object to the back of the array, nothing already in the array moves
+/// \param segmented the segmented array
+/// \param object the object to copy
+/// \return bool representing success of operation
+///
+bool dyn_segmented_push_back(dyn_segmented_t *const segmented, const void *const object);
+
+///
+/// Copies count objects to the back of the array, in order
+/// \param segmented the segmented array
+/// \param objects the objects to copy (a plain array of count objects)
+/// \param count the number of objects
+/// \return bool representing success of operation (array is unchanged on failure)
+///
+bool dyn_segmented_push_back_n(dyn_segmented_t *const segmented, const void *const objects, const size_t count);
+
+///
+/// Removes and optionally destructs the object at the back of the array
+/// \param segmented the segmented array
+/// \return bool representing success of operation
+///
+bool dyn_segmented_pop_back(dyn_segmented_t *const segmented);
+
+///
+/// Removes the back object and copies it to the given location
+/// \param segmented the segmented array
+/// \param object the location to copy the object to
+/// \return bool representing success of operation
+///
+bool dyn_segmented_extract_back(dyn_segmented_t *const segmented, void *const object);
+
+///
+/// Removes and optionally destructs all objects, segments are kept for reuse
+/// \param segmented the segmented array
+///
+void dyn_segmented_clear(dyn_segmented_t *const segmented);
+
+///
+/// Tests if the array is empty
+/// \param segmented the segmented array
+/// \return bool representing emptiness (true on error)
+///
+bool dyn_segmented_empty(const dyn_segmented_t *const segmented);
+
+///
+/// Returns the number of objects in the array
+/// \param segmented the segmented array
+/// \return number of objects, 0 on error
+///
+size_t dyn_segmented_size(const dyn_segmented_t *const segmented);
+
+///
+/// Returns the number of objects the array can hold without adding a segment
+/// \param segmented the segmented array
+/// \return capacity, 0 on error
+///
+size_t dyn_segmented_capacity(const dyn_segmented_t *const segmented);
+
+///
+/// Returns the size of the objects stored in the array
+/// \param segmented the segmented array
+/// \return object size, 0 on error
+///
+size_t dyn_segmented_data_size(const dyn_segmented_t *const segmented);
+
+///
+/// Adds segments until the array can hold at least capacity objects
+/// \param segmented the segmented array
+/// \param capacity the number of objects to make room for
+/// \return bool representing success of operation
+///
+bool dyn_segmented_reserve(dyn_segmented_t *const segmented, const size_t capacity);
+
+///
+/// Frees the segments past the one holding the back object
+/// \param segmented the segmented array
+/// \return bool representing success of operation
+///
+bool dyn_segmented_shrink_to_fit(dyn_segmented_t *const segmented);
+
+///
+/// Applies the given function to every object in the array, in order
+/// \param segmented the segmented array
+/// \param func the function to apply
+/// \param arg argument that will be passed to the function (as parameter 2)
+/// \return bool representing success of operation (really just pointer checks)
+///
+bool dyn_segmented_for_each(dyn_segmented_t *const segmented, void (*func)(void *const, void *), void *arg);
+
+///
+/// Applies the given function to every contiguous run of objects in the array, in order
+/// Same as dyn_array_for_each_span, each segment is a run (split up by max_span)
+/// \param segmented the segmented array
+/// \param func the function to apply (base of the run, number of objects, arg)
+/// \param arg argument that will be passed to the function (as parameter 3)
+/// \param max_span the most objects to hand out per call (0 for no limit)
+/// \return bool representing success of operation (really just pointer checks)
+///
+bool dyn_segmented_for_each_span(dyn_segmented_t *const segmented, void (*func)(void *const, const size_t, void *),
+                                 void *arg, const size_t max_span);
+
 /*
 // PIT OF DEPRECATION
 
@@ -266,4 +1109,8 @@ bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*func)(void * const,
 bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*func)(void *const));
 */
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+#ifndef DYN_ARRAY_HPP__
+#define DYN_ARRAY_HPP__
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "dyn_array.h"
+
+// Header-only C++ wrapper over dyn_array_t
+// Same storage, same C library doing the work, but with RAII, moves, and iterators that
+// <algorithm> is happy with (they're plain pointers, the contents are always one contiguous T array)
+
+namespace osf {
+
+///
+/// dyn_array_t holding T
+/// The C library moves objects around with memcpy/memmove/realloc, so T has to survive being
+///  relocated byte for byte. Most types do (ints, structs, unique_ptr, vector), but anything that
+///  points into itself doesn't (libstdc++'s std::string, for one). Don't put those in here.
+/// Non-trivial destructors get bridged to the C destructor, so erase/pop/clear run ~T()
+/// Anything non-const that hands out a T& or T* (iterators included) makes the C side forget it was
+///  sorted, since it can't see what gets written through them. Use a const view to keep that.
+/// Allocation failures throw std::bad_alloc, at() throws std::out_of_range
+///
+template <typename T>
+class dyn_array {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "dyn_array storage is only malloc aligned");
+
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    dyn_array() : handle_(create(0)) {}
+
+    explicit dyn_array(const size_type capacity) : handle_(create(capacity)) {}
+
+    dyn_array(std::initializer_list<T> init) : handle_(create(init.size())) { fill(init.begin(), init.end()); }
+
+    dyn_array(const dyn_array &other) : handle_(create(other.size())) { fill(other.begin(), other.end()); }
+
+    ///
+    /// Steals the handle, the moved-from array is empty (and allocates again if you use it)
+    ///
+    dyn_array(dyn_array &&other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+
+    ///
+    /// Takes ownership of an existing dyn_array_t, which has to hold objects of sizeof(T)
+    /// Whatever destructor it was created with stays, so make sure it's the right one (or none)
+    ///
+    explicit dyn_array(dyn_array_t *const adopt) : handle_(adopt) {
+        if (!adopt || dyn_array_data_size(adopt) != sizeof(T)) {
+            handle_ = nullptr;
+            throw std::invalid_argument("osf::dyn_array: adopted dyn_array_t doesn't hold this type");
+        }
+    }
+
+    ~dyn_array() { dyn_array_destroy(handle_); }
+
+    dyn_array &operator=(const dyn_array &other) {
+        if (this != &other) {
+            dyn_array copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    dyn_array &operator=(dyn_array &&other) noexcept {
+        if (this != &other) {
+            dyn_array_destroy(handle_);
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    void swap(dyn_array &other) noexcept { std::swap(handle_, other.handle_); }
+
+    reference operator[](const size_type index) { return *static_cast<T *>(dyn_array_at(writable(), index)); }
+    const_reference operator[](const size_type index) const {
+        return *static_cast<const T *>(dyn_array_at(handle_, index));
+    }
+
+    reference at(const size_type index) {
+        writable();
+        return *static_cast<T *>(checked_at(index));
+    }
+    const_reference at(const size_type index) const { return *static_cast<const T *>(checked_at(index)); }
+
+    reference front() { return *static_cast<T *>(dyn_array_front(writable())); }
+    const_reference front() const { return *static_cast<const T *>(dyn_array_front(handle_)); }
+    reference back() { return *static_cast<T *>(dyn_array_back(writable())); }
+    const_reference back() const { return *static_cast<const T *>(dyn_array_back(handle_)); }
+
+    ///
+    /// Contents as a plain array (straightens out a ring, if someone turned that on through the handle)
+    /// \return pointer to the first object, nullptr if empty
+    ///
+    T *data() { return static_cast<T *>(const_cast<void *>(dyn_array_export(writable()))); }
+    const T *data() const { return static_cast<const T *>(dyn_array_export(handle_)); }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    bool empty() const { return dyn_array_empty(handle_); }
+    size_type size() const { return dyn_array_size(handle_); }
+    size_type capacity() const { return dyn_array_capacity(handle_); }
+
+    void reserve(const size_type capacity) {
+        if (!dyn_array_reserve(live_handle(), capacity)) {
+            throw std::bad_alloc();
+        }
+    }
+
+    // a request, same as the C version
+    void shrink_to_fit() { dyn_array_shrink_to_fit(handle_); }
+
+    void clear() { dyn_array_clear(handle_); }
+
+    void push_back(const T &object) { emplace_back(object); }
+    void push_back(T &&object) { emplace_back(std::move(object)); }
+
+    template <typename... Args>
+    reference emplace_back(Args &&... args) {
+        relocate_in(size(), std::forward<Args>(args)...);
+        return back();
+    }
+
+    void pop_back() { dyn_array_pop_back(handle_); }
+
+    iterator insert(const_iterator position, const T &object) { return emplace(position, object); }
+    iterator insert(const_iterator position, T &&object) { return emplace(position, std::move(object)); }
+
+    ///
+    /// Inserts in front of position, anywhere from begin() to end()
+    /// Throws std::out_of_range if position isn't in there
+    ///
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args &&... args) {
+        const size_type index = position - cbegin();
+        if (index > size()) {
+            throw std::out_of_range("osf::dyn_array::emplace");
+        }
+        relocate_in(index, std::forward<Args>(args)...);
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator position) {
+        const size_type index = position - cbegin();
+        dyn_array_erase(handle_, index);
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type index = first - cbegin();
+        if (last != first) {
+            dyn_array_erase_n(handle_, index, last - first);
+        }
+        return begin() + index;
+    }
+
+    ///
+    /// The raw dyn_array_t, for the C API. Still ours, don't destroy it.
+    /// (nullptr if this array was moved from and hasn't been used since)
+    ///
+    dyn_array_t *handle() noexcept { return handle_; }
+    const dyn_array_t *handle() const noexcept { return handle_; }
+
+    ///
+    /// Gives up the raw dyn_array_t, it's yours to dyn_array_destroy now
+    /// This array is left empty
+    ///
+    dyn_array_t *release() noexcept {
+        dyn_array_t *const released = handle_;
+        handle_ = nullptr;
+        return released;
+    }
+
+  private:
+    static void destruct(void *object) { static_cast<T *>(object)->~T(); }
+
+    static dyn_array_t *create(const size_type capacity) {
+        dyn_array_t *const created =
+            dyn_array_create(capacity, sizeof(T), std::is_trivially_destructible<T>::value ? nullptr : &destruct);
+        if (!created) {
+            throw std::bad_alloc();
+        }
+        return created;
+    }
+
+    // Constructors copy in through here. A constructor that throws never gets its destructor run,
+    // so if a copy (or the allocation) throws partway, everything copied so far goes with the handle
+    template <typename Iterator>
+    void fill(Iterator first, const Iterator last) {
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            dyn_array_destroy(handle_);
+            handle_ = nullptr;
+            throw;
+        }
+    }
+
+    dyn_array_t *live_handle() {
+        if (!handle_) {
+            handle_ = create(0);
+        }
+        return handle_;
+    }
+
+    // For the non-const accessors. The C side's sorted flag can't survive writes it doesn't see
+    dyn_array_t *writable() {
+        dyn_array_mark_unsorted(handle_);
+        return handle_;
+    }
+
+    void *checked_at(const size_type index) const {
+        void *const object = dyn_array_at(handle_, index);
+        if (!object) {
+            throw std::out_of_range("osf::dyn_array::at");
+        }
+        return object;
+    }
+
+    // Builds the object on the side, then the C library copies its bytes into place.
+    // That copy IS the move, the local never gets destructed (relocation, see the class notes).
+    // Built first so args pointing into this array are still good if the insert reallocates.
+    template <typename... Args>
+    void relocate_in(const size_type index, Args &&... args) {
+        dyn_array_t *const target = live_handle();
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer;
+        T *const object = ::new (static_cast<void *>(&buffer)) T(std::forward<Args>(args)...);
+        if (!dyn_array_insert(target, index, object)) {
+            object->~T();
+            throw std::bad_alloc();
+        }
+    }
+
+    dyn_array_t *handle_;
+};
+
+template <typename T>
+void swap(dyn_array<T> &a, dyn_array<T> &b) noexcept {
+    a.swap(b);
+}
+
+}  // namespace osf
+
+#endif
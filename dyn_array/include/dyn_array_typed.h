@@ -0,0 +1,204 @@
+#ifndef dyn_array_typed_H__
+#define dyn_array_typed_H__
+
+#include "dyn_array.h"
+
+/*
+	Typed dyn_arrays!
+
+	DYN_ARRAY_DEFINE(name, T) stamps out name_t, a dyn_array that only holds T,
+	  plus a family of static inline name_* functions to go with it.
+
+	ex: DYN_ARRAY_DEFINE(int_array, int)
+	    int_array_t numbers;
+	    int_array_init(&numbers, 0);
+	    int_array_push_back(&numbers, 42);
+	    *int_array_at(&numbers, 0) += 1;
+	    int_array_destroy(&numbers);
+
+	Everything is visible to the compiler and the object size is a constant,
+	  so at() is just pointer math and push/pop are an assignment and a bounds check.
+
+	Contents are a plain T array, same layout dyn_array_export hands out,
+	  so name_export/name_import trade contents with a generic dyn_array_t.
+
+	The catch:
+	  No destructors, objects are just assigned and forgotten.
+	  No ring mode, push_front/pop_front/insert/erase shift things around (memmove).
+	  Put DYN_ARRAY_DEFINE somewhere at file scope, once per type per translation unit.
+
+	Same rules as dyn_array otherwise. Bad pointers are caught, functions return false or NULL.
+*/
+
+// Same starting capacity as dyn_array
+#define DYN_ARRAY_TYPED_MIN_CAPACITY 16
+
+#define DYN_ARRAY_DEFINE(name, T)                                                                       \
+    typedef struct {                                                                                    \
+        T *data;                                                                                        \
+        size_t size;                                                                                    \
+        size_t capacity;                                                                                \
+    } name##_t;                                                                                         \
+                                                                                                        \
+    /* Reallocates to exactly new_capacity objects (can't drop below size) */                          \
+    static inline bool name##_resize(name##_t *const array, const size_t new_capacity) {               \
+        if (new_capacity >= array->size && new_capacity && new_capacity <= SIZE_MAX / sizeof(T)) {      \
+            T *const new_data = (T *) realloc(array->data, new_capacity * sizeof(T));                   \
+            if (new_data) {                                                                             \
+                array->data = new_data;                                                                 \
+                array->capacity = new_capacity;                                                         \
+                return true;                                                                            \
+            }                                                                                           \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    /* Makes room for count more objects, doubling like dyn_array does */                              \
+    static inline bool name##_grow(name##_t *const array, const size_t count) {                        \
+        if (array->capacity - array->size >= count) {                                                   \
+            return true;                                                                                \
+        }                                                                                               \
+        if (count > SIZE_MAX / sizeof(T) - array->size) {                                               \
+            return false;                                                                               \
+        }                                                                                               \
+        size_t new_capacity = array->capacity ? array->capacity : DYN_ARRAY_TYPED_MIN_CAPACITY;         \
+        while (new_capacity < array->size + count) {                                                    \
+            new_capacity = new_capacity > SIZE_MAX / sizeof(T) / 2 ? SIZE_MAX / sizeof(T)               \
+                                                                    : new_capacity * 2;                 \
+        }                                                                                               \
+        return name##_resize(array, new_capacity);                                                      \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_init(name##_t *const array, const size_t capacity) {                     \
+        if (array) {                                                                                    \
+            array->data = NULL;                                                                         \
+            array->size = 0;                                                                            \
+            array->capacity = 0;                                                                        \
+            return name##_grow(array, capacity ? capacity : DYN_ARRAY_TYPED_MIN_CAPACITY);              \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline void name##_destroy(name##_t *const array) {                                         \
+        if (array) {                                                                                    \
+            free(array->data);                                                                          \
+            array->data = NULL;                                                                         \
+            array->size = 0;                                                                            \
+            array->capacity = 0;                                                                        \
+        }                                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    static inline T *name##_at(const name##_t *const array, const size_t index) {                      \
+        return array && index < array->size ? array->data + index : NULL;                               \
+    }                                                                                                   \
+                                                                                                        \
+    static inline T *name##_front(const name##_t *const array) {                                       \
+        return name##_at(array, 0);                                                                     \
+    }                                                                                                   \
+                                                                                                        \
+    static inline T *name##_back(const name##_t *const array) {                                        \
+        return array && array->size ? array->data + array->size - 1 : NULL;                             \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_push_back(name##_t *const array, const T object) {                       \
+        if (array && name##_grow(array, 1)) {                                                           \
+            array->data[array->size++] = object;                                                        \
+            return true;                                                                                \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_pop_back(name##_t *const array) {                                        \
+        if (array && array->size) {                                                                     \
+            --array->size;                                                                              \
+            return true;                                                                                \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_extract_back(name##_t *const array, T *const object) {                   \
+        if (array && array->size && object) {                                                           \
+            *object = array->data[--array->size];                                                       \
+            return true;                                                                                \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_insert(name##_t *const array, const size_t index, const T object) {      \
+        if (array && index <= array->size && name##_grow(array, 1)) {                                   \
+            memmove(array->data + index + 1, array->data + index, (array->size - index) * sizeof(T));   \
+            array->data[index] = object;                                                                \
+            ++array->size;                                                                              \
+            return true;                                                                                \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_extract(name##_t *const array, const size_t index, T *const object) {    \
+        if (array && index < array->size && object) {                                                   \
+            *object = array->data[index];                                                               \
+            memmove(array->data + index, array->data + index + 1,                                       \
+                    (array->size - index - 1) * sizeof(T));                                             \
+            --array->size;                                                                              \
+            return true;                                                                                \
+        }                                                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_erase(name##_t *const array, const size_t index) {                       \
+        T object;                                                                                       \
+        return name##_extract(array, index, &object);                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_push_front(name##_t *const array, const T object) {                      \
+        return name##_insert(array, 0, object);                                                         \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_pop_front(name##_t *const array) {                                       \
+        return name##_erase(array, 0);                                                                  \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_extract_front(name##_t *const array, T *const object) {                  \
+        return name##_extract(array, 0, object);                                                        \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_reserve(name##_t *const array, const size_t capacity) {                  \
+        return array && (capacity <= array->capacity || name##_resize(array, capacity));                \
+    }                                                                                                   \
+                                                                                                        \
+    static inline void name##_clear(name##_t *const array) {                                           \
+        if (array) {                                                                                    \
+            array->size = 0;                                                                            \
+        }                                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool name##_empty(const name##_t *const array) {                                     \
+        return !array || !array->size;                                                                  \
+    }                                                                                                   \
+                                                                                                        \
+    static inline size_t name##_size(const name##_t *const array) {                                    \
+        return array ? array->size : 0;                                                                 \
+    }                                                                                                   \
+                                                                                                        \
+    /* Copies the contents into a new generic dyn_array_t (no destructor), NULL on error */            \
+    static inline dyn_array_t *name##_export(const name##_t *const array) {                            \
+        return array && array->size ? dyn_array_import(array->data, array->size, sizeof(T), NULL)       \
+                                    : array ? dyn_array_create(0, sizeof(T), NULL) : NULL;              \
+    }                                                                                                   \
+                                                                                                        \
+    /* Replaces the contents with a copy of a generic dyn_array_t's, which has to hold Ts */           \
+    static inline bool name##_import(name##_t *const array, const dyn_array_t *const source) {         \
+        if (array && source && dyn_array_data_size(source) == sizeof(T)) {                              \
+            const size_t count = dyn_array_size(source);                                                \
+            if (count <= array->capacity || name##_resize(array, count)) {                              \
+                if (count) {                                                                            \
+                    memcpy(array->data, dyn_array_export(source), count * sizeof(T));                   \
+                }                                                                                       \
+                array->size = count;                                                                    \
+                return true;                                                                            \
+            }                                                                                           \
+        }                                                                                               \
+        return false;                                                                                   \
+    }
+
+#endif
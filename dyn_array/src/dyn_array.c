@@ -1,20 +1,89 @@
+// mremap is a GNU extension
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
 #include "../include/dyn_array.h"
 
+#include <pthread.h>
+
+#include <stdio.h>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+// Only if mremap actually showed up (it won't if someone got to the headers before _GNU_SOURCE did)
+#if defined(MREMAP_MAYMOVE)
+    #define DYN_USE_MMAP
+#endif
+// dyn_array_map maps files if it can, otherwise it just reads them in
+#if defined(MAP_PRIVATE)
+    #define DYN_USE_FILE_MAP
+#endif
+
 // Flag values
-// SHRUNK to indicate shrink_to_fit was called and size needs to be rehandled
-// SORTED to track if the objects have been sorted by us (sorted is set by sort and unset by insert/push)
-// these are just ideas
-//typedef enum {NONE = 0x00, SHRUNK = 0x01, SORTED = 0x02, ALL = 0xFF} DYN_FLAGS;
+// SHRUNK to indicate shrink_to_fit (or reserve) left us with an odd capacity and growth needs to be rehandled
+// RING to indicate we're a circular buffer, contents start at head and may wrap around the end of the array
+// SORTED to track if the objects are in order by the comparator in sorted_by
+//  (set by sort, kept by anything that removes objects or inserts them in order, unset by everything else)
+// MAPPED to indicate the contents are a private mapping of a file (from dyn_array_map), not ours to realloc
+// READ_ONLY to indicate the contents can't be touched at all (a read-only dyn_array_map)
+typedef enum {NONE = 0x00, SHRUNK = 0x01, SORTED = 0x02, RING = 0x04, MAPPED = 0x08, READ_ONLY = 0x10, ALL = 0xFF} DYN_FLAGS;
+
+// Size specialized copy/walk/swap, one table per common object size (and a generic one)
+// Picked once at creation, so the hot paths don't pay for a runtime-length memcpy
+typedef struct {
+    void (*swap)(uint8_t *, uint8_t *, const size_t);
+    void (*move)(uint8_t *, const uint8_t *, const size_t);
+    void (*copy)(uint8_t *, const uint8_t *, const size_t, const size_t);
+    void (*walk)(uint8_t *, size_t, const size_t, void (*)(void *const, void *), void *);
+} dyn_kernels_t;
 
 struct dyn_array {
-    // DYN_FLAGS flags;
+    DYN_FLAGS flags;
+    DYN_GROWTH_POLICY growth;
+    size_t max_step;
+    size_t head; // slot of the front object, always 0 unless we're a ring
     size_t capacity;
     size_t size;
     size_t data_size;
     void *array;
+    void *scratch; // sort workspace, kept around for the next sort, freed by shrink_to_fit
+    size_t scratch_size; // in bytes
     void (*destructor)(void *);
+    const dyn_kernels_t *kernels; // copy/walk/swap for our data_size, picked at creation
+    dyn_allocator_t allocator; // where the struct, contents and scratch come from
+    size_t inline_capacity; // objects that fit in the buffer we were built in, 0 if we're on the heap
+    size_t heap_arity; // children per node for the heap functions
+    int (*sorted_by)(const void *, const void *); // what SORTED means, the last comparator we sorted with
 };
 
+// The struct has to fit in front of the objects in an inline buffer (fails to compile if it doesn't)
+typedef char dyn_inline_overhead_check[sizeof(struct dyn_array) <= DYN_ARRAY_INLINE_OVERHEAD ? 1 : -1];
+
+// Where an inline array keeps its objects, right after the header the user gave room for
+#define DYN_INLINE_STORAGE(dyn_array_ptr) (((uint8_t *) dyn_array_ptr) + DYN_ARRAY_INLINE_OVERHEAD)
+// True if the contents are currently in the inline buffer (instead of spilled out to the heap)
+#define DYN_IS_INLINE(dyn_array_ptr) (dyn_array_ptr->inline_capacity && \
+                                      (uint8_t *) dyn_array_ptr->array == DYN_INLINE_STORAGE(dyn_array_ptr))
+
+#define DYN_FLAG_CHECK(dyn_array_ptr, flag) (dyn_array_ptr->flags & (flag))
+#define DYN_FLAG_SET(dyn_array_ptr, flag) (dyn_array_ptr->flags |= (flag))
+#define DYN_FLAG_UNSET(dyn_array_ptr, flag) (dyn_array_ptr->flags &= ~(flag))
+// True if the contents are known to be in order by this comparator
+#define DYN_IS_SORTED(dyn_array_ptr, compare) (DYN_FLAG_CHECK(dyn_array_ptr, SORTED) && dyn_array_ptr->sorted_by == (compare))
+// Records that the contents are in order by compare
+#define DYN_SET_SORTED(dyn_array_ptr, compare) ((dyn_array_ptr)->flags |= SORTED, (dyn_array_ptr)->sorted_by = (compare))
+
+// Anything that changes the contents (or size) checks this first
+#define DYN_WRITABLE(dyn_array_ptr) (!DYN_FLAG_CHECK(dyn_array_ptr, READ_ONLY))
+
+// Starting capacity, and the smallest step growth will ever take
+#define DYN_MIN_CAPACITY 16
+
 // Supports 64bit+ size_t!
 // Semi-arbitrary cap on contents. We'll run out of memory before this happens anyway.
 // Allowing it to be externally set
@@ -22,8 +91,61 @@ struct dyn_array {
     #define DYN_MAX_CAPACITY (((size_t)1) << ((sizeof(size_t) << 3) - 8))
 #endif
 
+// Blocks this big (in bytes) get their own anonymous mapping instead of malloc (Linux only)
+// Growing one is then an mremap, the kernel moves page table entries instead of us copying every byte
+// Allowing it to be externally set
+#ifndef DYN_MMAP_THRESHOLD
+    #define DYN_MMAP_THRESHOLD (((size_t) 1) << 26)
+#endif
+
+// Parallel sort tuning. Each thread gets at least this many objects, or it's not worth the thread.
+// Allowing it to be externally set
+#ifndef DYN_PARALLEL_SORT_MIN_CHUNK
+    #define DYN_PARALLEL_SORT_MIN_CHUNK 32768
+#endif
+// More threads than this just get ignored (sorts, for_each and reduce)
+#define DYN_PARALLEL_MAX_THREADS 64
+// Fewest objects per thread for parallel for_each/reduce when the caller doesn't pick
+#define DYN_PARALLEL_DEFAULT_GRAIN 4096
+// Parallel chunks start on cache lines so threads don't fight over the line they share
+#define DYN_CACHE_LINE 64
+
+// What dyn_array_save puts in front of the contents
+// Contents are written as-is, so files only make sense on the same kind of machine (byte_order catches the obvious)
+// The header is padded out so the contents start on a cache line in a mapping
+#define DYN_FILE_MAGIC "DYNARRAY"
+#define DYN_FILE_VERSION 1
+#define DYN_FILE_BYTE_ORDER 0x01020304
+#define DYN_FILE_HEADER_SIZE 64
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t data_size;
+    uint8_t padding[DYN_FILE_HEADER_SIZE - 40];
+} dyn_file_header_t;
+typedef char dyn_file_header_check[sizeof(dyn_file_header_t) == DYN_FILE_HEADER_SIZE ? 1 : -1];
+
+// Where dyn_array_save's spans go, failed sticks once a write comes up short
+typedef struct {
+    FILE *file;
+    size_t data_size;
+    bool failed;
+} dyn_file_writer_t;
+
 // casts pointer and does arithmatic to get index of element
+// This is the PHYSICAL slot, only the same as the logical index when head is 0 (which it is unless we're a ring)
+// Anything that memmoves blocks around uses this, after making sure we're linear
 #define DYN_ARRAY_POSITION(dyn_array_ptr, idx) (((uint8_t*)dyn_array_ptr->array) + ((idx) * dyn_array_ptr->data_size))
+// Translates a logical index to its physical slot, wrapping around the end in ring mode
+// (idx must be <= capacity, which it always is if it's <= size)
+#define DYN_ARRAY_SLOT(dyn_array_ptr, idx) (((idx) < dyn_array_ptr->capacity - dyn_array_ptr->head) ? \
+                                            dyn_array_ptr->head + (idx) : (idx) - (dyn_array_ptr->capacity - dyn_array_ptr->head))
+// Logical version of DYN_ARRAY_POSITION, safe for anything that only looks at one object at a time
+#define DYN_ARRAY_AT(dyn_array_ptr, idx) DYN_ARRAY_POSITION(dyn_array_ptr, DYN_ARRAY_SLOT(dyn_array_ptr, idx))
 // Gets the size (in bytes) of n dyn_array elements
 #define DYN_SIZE_N_ELEMS(dyn_array_ptr, n) (dyn_array_ptr->data_size * (n))
 
@@ -35,29 +157,280 @@ typedef enum {CREATE_GAP = 0x01, FILL_GAP = 0x02, FILL_GAP_DESTRUCT = 0x06} DYN_
 // The core of any insert/remove operation, check the impl for details
 bool dyn_shift(dyn_array_t *const dyn_array, const size_t position, const size_t count, const DYN_SHIFT_MODE mode, void *const data_location);
 
+// Modes of operation for dyn_merge_sorted, which objects of two sorted arrays make it into the output
+// ALL: everything (a plain merge), UNION: equal pairs once, INTERSECTION: only equal pairs, DIFFERENCE: a's without a match in b
+typedef enum {MERGE_ALL = 0x00, MERGE_UNION = 0x01, MERGE_INTERSECTION = 0x02, MERGE_DIFFERENCE = 0x03} DYN_MERGE_MODE;
+
+// The core of merge and the set functions, appends the selected objects to dst, check the impl for details
+bool dyn_merge_sorted(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                      int (*compare)(const void *, const void *), const DYN_MERGE_MODE mode);
+
+// End of the run of objects equal to the one at physical slot first (array must be linear)
+// Gallops and binary searches when the array is known to be sorted, steps one at a time otherwise
+size_t dyn_equal_run_end(const dyn_array_t *const dyn_array, const size_t first,
+                         int (*compare)(const void *, const void *));
+
+// Moves the back object into the (already emptied) slot at index, size drops by one
+void dyn_fill_from_back(dyn_array_t *const dyn_array, const size_t index);
+
+// Checks to see if the object can handle an increase in size (and optionally increases capacity)
+bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
+
+// Reallocates the array to hold exactly new_capacity objects (can't drop below size)
+bool dyn_resize_capacity(dyn_array_t *const dyn_array, const size_t new_capacity);
+
+// dyn_resize_capacity for inline arrays moving into or out of their buffer
+bool dyn_resize_inline(dyn_array_t *const dyn_array, const size_t new_capacity);
+
+// Rotates a ring's contents so they start at slot 0, then everything's a plain array again
+void dyn_linearize(dyn_array_t *const dyn_array);
+
+// Reverses the objects in physical slots [first, last), linearize's plan B
+void dyn_reverse(dyn_array_t *const dyn_array, const size_t first, const size_t last);
+
+// Ring mode version of dyn_shift for gaps at either end, check the impl for details
+bool dyn_ring_shift(dyn_array_t *const dyn_array, const size_t position, const size_t count, const DYN_SHIFT_MODE mode, void *const data_location);
+
+// Binary search core for the sorted functions, check the impl for details
+size_t dyn_partition_point(const dyn_array_t *const dyn_array, const void *const object,
+                           int (*compare)(const void *, const void *), const bool upper);
+
+// Heap sifts move a hole instead of swapping, object lives outside the heap (or past size) until it lands
+// Returns the slot object belongs in, the caller moves it there
+// (heap functions linearize first, so physical slots are logical indices)
+// Up: parents smaller than object move down into the hole
+size_t dyn_heap_sift_up(dyn_array_t *const dyn_array, size_t hole, const uint8_t *const object,
+                        int (*compare)(const void *, const void *));
+
+// Down: the biggest child moves up into the hole, while it's bigger than object
+size_t dyn_heap_sift_down(dyn_array_t *const dyn_array, size_t hole, const uint8_t *const object,
+                          int (*compare)(const void *, const void *));
+
+// Fills the (already emptied) top of the heap with the back object, size drops by one
+void dyn_heap_pop_top(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *));
+
+// Sifts the object at index whichever way it needs to go (uses the scratch buffer to hold it)
+bool dyn_heap_resift(dyn_array_t *const dyn_array, const size_t index, int (*compare)(const void *, const void *));
+
+// True if inserting count objects (back to back at objects) at logical index position keeps a SORTED array in order
+bool dyn_sorted_insert_keeps_order(const dyn_array_t *const dyn_array, const size_t position, const size_t count,
+                                   const uint8_t *const objects);
+
+// Checks every neighboring pair, true if nothing's out of order
+bool dyn_scan_sorted(const dyn_array_t *const dyn_array, int (*compare)(const void *, const void *));
+
+// Runs the tasks (each task_size bytes) on their own threads and waits for all of them
+void dyn_run_tasks(void *const tasks, const size_t task_size, const size_t count, void *(*func)(void *));
+
+// Splits the array into (at most) nthreads chunks of at least grain objects, returns how many
+// bounds gets chunks + 1 entries, chunk n is [bounds[n], bounds[n + 1])
+size_t dyn_parallel_bounds(const dyn_array_t *const dyn_array, size_t nthreads, size_t grain, size_t *const bounds);
+
+// One chunk of a parallel for_each or reduce
+// Accumulators are padded out to cache lines too, and each one is only touched by its own thread
+typedef struct {
+    uint8_t *first;
+    uint8_t *last;
+    size_t data_size;
+    const dyn_kernels_t *kernels;
+    void (*func)(void *const, void *);
+    void (*accumulate)(void *const, const void *const, void *);
+    void *accumulator;
+    void *arg;
+} dyn_parallel_task_t;
+
+// Thread bodies for parallel for_each and reduce, one chunk each
+void *dyn_parallel_task_for_each(void *task_ptr);
+void *dyn_parallel_task_reduce(void *task_ptr);
+
+// Picks the kernel table for the object size
+const dyn_kernels_t *dyn_select_kernels(const size_t data_size);
+
+// Drops a mapped array's file mapping (contents are gone after this)
+void dyn_unmap_file(dyn_array_t *const dyn_array);
+
+// dyn_resize_capacity for mapped arrays, contents get copied out of the file and the mapping goes away
+bool dyn_resize_mapped(dyn_array_t *const dyn_array, const size_t new_capacity);
+
+// Checks a header read from a file holding file_size bytes
+bool dyn_file_header_valid(const dyn_file_header_t *const header, const size_t file_size);
+
+// Span callback for dyn_array_save, writes the run to the file (arg is a dyn_file_writer_t)
+void dyn_file_write_span(void *const first, const size_t count, void *writer_ptr);
+
+// Sets up a fresh (empty) array, everything but the storage
+void dyn_init(dyn_array_t *const dyn_array, const size_t capacity, const size_t data_type_size,
+              void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+
+// Adds segments until a segmented array can hold capacity objects (capacity can't pass DYN_MAX_CAPACITY)
+bool dyn_segmented_grow(dyn_segmented_t *const segmented, const size_t capacity);
+
+// Span callback that runs the destructor on a run of segmented objects (arg is the segmented array)
+void dyn_segmented_destruct_span(void *const first, const size_t count, void *segmented_ptr);
+
+// Asks for transparent huge pages on a mapped block, it's only a hint (and a no-op off Linux)
+void dyn_advise_huge(void *const ptr, const size_t bytes);
+
+// Allocator wrappers, fill in for whatever callbacks the allocator left out
+void *dyn_alloc(const dyn_allocator_t *const allocator, const size_t bytes);
+void *dyn_realloc(const dyn_allocator_t *const allocator, void *const ptr, const size_t old_bytes, const size_t new_bytes);
+void dyn_free(const dyn_allocator_t *const allocator, void *const ptr, const size_t bytes);
+
+// Everything the sort engine needs to know about the objects, kernels are picked by size
+typedef struct {
+    size_t size;
+    int (*compare)(const void *, const void *);
+    void (*swap)(uint8_t *, uint8_t *, const size_t);
+    void (*move)(uint8_t *, const uint8_t *, const size_t);
+} dyn_sorter_t;
+
+// Picks the swap/move kernels for the object size
+void dyn_sorter_init(dyn_sorter_t *const sorter, const size_t data_size, int (*compare)(const void *, const void *));
+
+// Pattern-defeating quicksort core, check the impl for details
+void dyn_pdqsort(const dyn_sorter_t *const sorter, uint8_t *base, size_t count, size_t bad_allowed, bool leftmost);
+
+// Unstable sort of a plain buffer, what dyn_array_sort runs on the (linearized) array
+void dyn_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                     int (*compare)(const void *, const void *));
+
+// Introselect core, check the impl for details
+void dyn_select(const dyn_sorter_t *const sorter, uint8_t *base, size_t count, size_t nth, size_t bad_allowed, bool leftmost);
+
+// Puts the object that belongs at nth there, smaller (or equal) ones before it, bigger (or equal) ones after
+void dyn_select_buffer(uint8_t *const base, const size_t count, const size_t nth, const size_t data_size,
+                       int (*compare)(const void *, const void *));
+
+// Runs count objects through a min-heap holding the k biggest seen so far (filled of them, until it's full)
+void dyn_top_k_feed(const dyn_sorter_t *const sorter, const uint8_t *source, size_t count,
+                    uint8_t *const heap, const size_t k, size_t *const filled);
+
+// Sorts a full top k heap biggest first
+void dyn_top_k_finish(const dyn_sorter_t *const sorter, uint8_t *const heap, const size_t k);
+
+// Stable merge sort of a plain buffer, scratch needs room for count / 2 objects
+void dyn_stable_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                            int (*compare)(const void *, const void *), uint8_t *const scratch);
+
+// LSD radix sort of a plain buffer, scratch needs room for count objects
+// Returns true if the sorted result ended up in scratch instead of base
+bool dyn_radix_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size, const size_t key_offset,
+                           const size_t key_width, const DYN_RADIX_FLAGS flags, uint8_t *const scratch);
+
+// Parallel merge sort of a plain buffer, scratch needs room for count objects
+// Returns true if the sorted result ended up in scratch instead of base
+bool dyn_parallel_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                              int (*compare)(const void *, const void *), size_t nthreads, uint8_t *const scratch);
+
+// Gets a scratch buffer of at least the given size, reusing the last one if it's big enough
+void *dyn_request_scratch(dyn_array_t *const dyn_array, const size_t bytes);
+
+
+// The allocator everyone gets from dyn_array_create
+// Small blocks are malloc's problem, big ones are mapped (the sizes we get told decide which is which)
+static void *dyn_default_alloc(void *context, size_t bytes) {
+    (void) context;
+#ifdef DYN_USE_MMAP
+    if (bytes >= DYN_MMAP_THRESHOLD) {
+        void *const ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            return NULL;
+        }
+        dyn_advise_huge(ptr, bytes);
+        return ptr;
+    }
+#endif
+    return malloc(bytes);
+}
+
+static void dyn_default_free(void *context, void *ptr, size_t bytes) {
+    (void) context;
+#ifdef DYN_USE_MMAP
+    if (bytes >= DYN_MMAP_THRESHOLD) {
+        munmap(ptr, bytes);
+        return;
+    }
+#endif
+    (void) bytes;
+    free(ptr);
+}
+
+static void *dyn_default_realloc(void *context, void *ptr, size_t old_bytes, size_t new_bytes) {
+#ifdef DYN_USE_MMAP
+    if (old_bytes >= DYN_MMAP_THRESHOLD && new_bytes >= DYN_MMAP_THRESHOLD) {
+        // Grows remap the pages wherever there's room, shrinks hand the tail pages back to the kernel
+        void *const new_ptr = mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (new_ptr == MAP_FAILED) {
+            return NULL;
+        }
+        if (new_bytes > old_bytes) {
+            dyn_advise_huge(new_ptr, new_bytes);
+        }
+        return new_ptr;
+    }
+    if (old_bytes >= DYN_MMAP_THRESHOLD || new_bytes >= DYN_MMAP_THRESHOLD) {
+        // crossing the threshold, one side's mapped and the other's malloc'd, so it's a copy either way
+        void *const new_ptr = dyn_default_alloc(context, new_bytes);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+            dyn_default_free(context, ptr, old_bytes);
+        }
+        return new_ptr;
+    }
+#endif
+    (void) context;
+    (void) old_bytes;
+    return realloc(ptr, new_bytes);
+}
+
+static const dyn_allocator_t dyn_default_allocator = {dyn_default_alloc, dyn_default_realloc, dyn_default_free, NULL};
 
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *)) {
-    if (data_type_size && capacity <= DYN_MAX_CAPACITY) {
-        dyn_array_t *dyn_array = (dyn_array_t *) malloc(sizeof(dyn_array_t));
+    return dyn_array_create_with_allocator(capacity, data_type_size, destruct_func, NULL);
+}
+
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+                                             void (*destruct_func)(void *), const dyn_allocator_t *const allocator) {
+    const dyn_allocator_t *const source = allocator ? allocator : &dyn_default_allocator;
+    if (data_type_size && capacity <= DYN_MAX_CAPACITY && source->alloc) {
+        dyn_array_t *dyn_array = (dyn_array_t *) source->alloc(source->context, sizeof(dyn_array_t));
         if (dyn_array) {
             // would have inf loop if requested size was between DYN_MAX_CAPACITY
             // and SIZE_MAX
-            size_t actual_capacity = 16;
+            size_t actual_capacity = DYN_MIN_CAPACITY;
             while (capacity > actual_capacity) {actual_capacity <<= 1;}
 
-            dyn_array->capacity = actual_capacity;
-            dyn_array->size = 0;
-            dyn_array->data_size = data_type_size;
-            dyn_array->destructor = destruct_func;
+            dyn_init(dyn_array, actual_capacity, data_type_size, destruct_func, source);
 
-            dyn_array->array = (uint8_t *) malloc(data_type_size * actual_capacity);
+            dyn_array->array = (uint8_t *) dyn_alloc(source, data_type_size * actual_capacity);
             if (dyn_array->array) {
                 // other malloc worked, yay!
                 // we're done?
                 return dyn_array;
             }
-            free(dyn_array);
+            dyn_free(source, dyn_array, sizeof(dyn_array_t));
+        }
+    }
+    return NULL;
+}
+
+dyn_array_t *dyn_array_init_inline(void *const buffer, const size_t buffer_size, const size_t data_type_size,
+                                   void (*destruct_func)(void *)) {
+    // the struct is all pointers and size_ts, so that's all the alignment it needs
+    if (buffer && data_type_size && !((uintptr_t) buffer & (sizeof(void *) - 1))
+            && buffer_size >= DYN_ARRAY_INLINE_OVERHEAD && (buffer_size - DYN_ARRAY_INLINE_OVERHEAD) / data_type_size) {
+        dyn_array_t *dyn_array = (dyn_array_t *) buffer;
+        size_t inline_capacity = (buffer_size - DYN_ARRAY_INLINE_OVERHEAD) / data_type_size;
+        if (inline_capacity > DYN_MAX_CAPACITY) {
+            inline_capacity = DYN_MAX_CAPACITY;
         }
+
+        dyn_init(dyn_array, inline_capacity, data_type_size, destruct_func, &dyn_default_allocator);
+        dyn_array->inline_capacity = inline_capacity;
+        dyn_array->array = DYN_INLINE_STORAGE(dyn_array);
+        // whatever fit in the buffer isn't a capacity the growth policy would pick
+        DYN_FLAG_SET(dyn_array, SHRUNK);
+        return dyn_array;
     }
     return NULL;
 }
@@ -83,14 +456,29 @@ dyn_array_t *dyn_array_import(const void *const data, const size_t count, const
 // or memcpy the pointer's value to a non-const pointer (my favorite trick)
 // Oh C...
 const void *dyn_array_export(const dyn_array_t *const dyn_array) {
+    if (dyn_array && dyn_array->head) {
+        // A wrapped ring can't be handed out as one block, so straighten it out first
+        // Contents don't change, just where they live, so the const is still honest. Mostly.
+        dyn_linearize((dyn_array_t *) dyn_array);
+    }
     return dyn_array_front(dyn_array);
 }
 
 void dyn_array_destroy(dyn_array_t *dyn_array) {
     if (dyn_array) {
         dyn_array_clear(dyn_array);
-        free(dyn_array->array);
-        free(dyn_array);
+        // the allocator lives in the struct we're about to give back
+        const dyn_allocator_t allocator = dyn_array->allocator;
+        dyn_free(&allocator, dyn_array->scratch, dyn_array->scratch_size);
+        if (DYN_FLAG_CHECK(dyn_array, MAPPED)) {
+            dyn_unmap_file(dyn_array);
+        } else if (!DYN_IS_INLINE(dyn_array)) {
+            dyn_free(&allocator, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+        }
+        // inline arrays live in the user's buffer, that's theirs to deal with
+        if (!dyn_array->inline_capacity) {
+            dyn_free(&allocator, dyn_array, sizeof(dyn_array_t));
+        }
     }
 }
 
@@ -102,7 +490,7 @@ void *dyn_array_front(const dyn_array_t *const dyn_array) {
         // If array is null, well, this is ok, because it's null
         // but if array is broken, well, we can't help that
         // nor can we detect that, so I guess it's not an error
-        return dyn_array->array;
+        return DYN_ARRAY_POSITION(dyn_array, dyn_array->head);
     }
     return NULL;
 }
@@ -133,7 +521,7 @@ bool dyn_array_extract_front(dyn_array_t *const dyn_array, void *const object) {
 
 void *dyn_array_back(const dyn_array_t *const dyn_array) {
     if (dyn_array && dyn_array->size) {
-        return DYN_ARRAY_POSITION(dyn_array, dyn_array->size - 1);
+        return DYN_ARRAY_AT(dyn_array, dyn_array->size - 1);
     }
     return NULL;
 }
@@ -168,7 +556,7 @@ bool dyn_array_extract_back(dyn_array_t *const dyn_array, void *const object) {
 
 void *dyn_array_at(const dyn_array_t *const dyn_array, const size_t index) {
     if (dyn_array && index < dyn_array->size) {
-        return DYN_ARRAY_POSITION(dyn_array, index);
+        return DYN_ARRAY_AT(dyn_array, index);
     }
     return NULL;
 }
@@ -188,6 +576,100 @@ bool dyn_array_extract(dyn_array_t *const dyn_array, const size_t index, void *c
            dyn_shift(dyn_array, index, 1, FILL_GAP, object);
 }
 
+bool dyn_array_erase_unordered(dyn_array_t *const dyn_array, const size_t index) {
+    if (dyn_array && index < dyn_array->size && DYN_WRITABLE(dyn_array)) {
+        if (dyn_array->destructor) {
+            dyn_array->destructor(DYN_ARRAY_AT(dyn_array, index));
+        }
+        dyn_fill_from_back(dyn_array, index);
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_extract_unordered(dyn_array_t *const dyn_array, const size_t index, void *const object) {
+    if (dyn_array && object && index < dyn_array->size && DYN_WRITABLE(dyn_array)) {
+        dyn_array->kernels->move((uint8_t *) object, DYN_ARRAY_AT(dyn_array, index), dyn_array->data_size);
+        dyn_fill_from_back(dyn_array, index);
+        return true;
+    }
+    return false;
+}
+
+
+
+
+// dyn_shift has done counts > 1 since forever, the API finally caught up
+
+bool dyn_array_push_front_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count) {
+    return objects && dyn_shift(dyn_array, 0, count, CREATE_GAP, (void *const)objects);
+}
+
+bool dyn_array_pop_front_n(dyn_array_t *const dyn_array, const size_t count) {
+    return dyn_shift(dyn_array, 0, count, FILL_GAP_DESTRUCT, NULL);
+}
+
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count) {
+    return objects && dyn_array && dyn_shift(dyn_array, dyn_array->size, count, CREATE_GAP, (void *const)objects);
+}
+
+bool dyn_array_pop_back_n(dyn_array_t *const dyn_array, const size_t count) {
+    // same rollover worry as pop_back
+    return dyn_array && dyn_array->size >= count &&
+           dyn_shift(dyn_array, dyn_array->size - count, count, FILL_GAP_DESTRUCT, NULL);
+}
+
+bool dyn_array_insert_n(dyn_array_t *const dyn_array, const size_t index,
+                        const void *const objects, const size_t count) {
+    return objects && dyn_shift(dyn_array, index, count, CREATE_GAP, (void *const)objects);
+}
+
+bool dyn_array_erase_n(dyn_array_t *const dyn_array, const size_t index, const size_t count) {
+    return dyn_shift(dyn_array, index, count, FILL_GAP_DESTRUCT, NULL);
+}
+
+bool dyn_array_extract_n(dyn_array_t *const dyn_array, const size_t index,
+                         void *const objects, const size_t count) {
+    return dyn_array && objects && dyn_array->size > index &&
+           dyn_shift(dyn_array, index, count, FILL_GAP, objects);
+}
+
+bool dyn_array_append(dyn_array_t *const dst, const dyn_array_t *const src) {
+    if (dst && src) {
+        return src->size == 0 || dyn_array_append_range(dst, src, 0, src->size);
+    }
+    return false;
+}
+
+bool dyn_array_append_range(dyn_array_t *const dst, const dyn_array_t *const src,
+                            const size_t first, const size_t count) {
+    if (dst && src && count && dst->data_size == src->data_size &&
+            first <= src->size && count <= src->size - first) {
+        if (src->head) {
+            // need the source range in one piece. Same deal as export, contents don't change.
+            dyn_linearize((dyn_array_t *) src);
+        }
+        if (dst == src) {
+            // Appending to ourselves. The realloc in the capacity increase can move the
+            // data out from under us, so grow first and copy from wherever it ended up.
+            // Source range is all below size, destination is all above it, no overlap.
+            if (DYN_FLAG_CHECK(dst, SORTED) && !dyn_sorted_insert_keeps_order(dst, dst->size, count,
+                                                                                DYN_ARRAY_POSITION(dst, first))) {
+                DYN_FLAG_UNSET(dst, SORTED);
+            }
+            if (dyn_request_size_increase(dst, count)) {
+                memcpy(DYN_ARRAY_POSITION(dst, dst->size), DYN_ARRAY_POSITION(dst, first),
+                       DYN_SIZE_N_ELEMS(dst, count));
+                dst->size += count;
+                return true;
+            }
+            return false;
+        }
+        return dyn_shift(dst, dst->size, count, CREATE_GAP, DYN_ARRAY_POSITION(src, first));
+    }
+    return false;
+}
+
 
 
 
@@ -197,6 +679,20 @@ void dyn_array_clear(dyn_array_t *const dyn_array) {
     }
 }
 
+bool dyn_array_set_ring_mode(dyn_array_t *const dyn_array, const bool enable) {
+    if (dyn_array) {
+        if (enable) {
+            DYN_FLAG_SET(dyn_array, RING);
+        } else {
+            // back to a plain old array, which starts at slot 0
+            dyn_linearize(dyn_array);
+            DYN_FLAG_UNSET(dyn_array, RING);
+        }
+        return true;
+    }
+    return false;
+}
+
 bool dyn_array_empty(const dyn_array_t *const dyn_array) {
     return dyn_array_size(dyn_array) == 0;
 }
@@ -227,134 +723,776 @@ size_t dyn_array_data_size(const dyn_array_t *const dyn_array) {
 bool dyn_array_sort(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
     // hah, turns out there's a quicksort in cstdlib.
     // and it works exactly like we want it to
-    if (dyn_array && dyn_array->size && compare) {
-        qsort(dyn_array->array, dyn_array->size, dyn_array->data_size, compare);
+    // ...except it swaps everything a byte at a time. We have our own now, check the sort engine.
+    if (dyn_array && dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        // Already sorted this way? One pass to make sure nobody changed anything through a pointer, and done
+        if (!DYN_IS_SORTED(dyn_array, compare) || !dyn_scan_sorted(dyn_array, compare)) {
+            dyn_linearize(dyn_array);
+            dyn_sort_buffer((uint8_t *) dyn_array->array, dyn_array->size, dyn_array->data_size, compare);
+            DYN_SET_SORTED(dyn_array, compare);
+        }
         return true;
     }
     return false;
 }
 
+bool dyn_array_sort_stable(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    if (dyn_array && dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        // in order is in order, nothing to keep stable
+        if (DYN_IS_SORTED(dyn_array, compare) && dyn_scan_sorted(dyn_array, compare)) {
+            return true;
+        }
+        // merges never need more than half the array in scratch (+1 so a single object still gets a buffer)
+        uint8_t *const scratch = (uint8_t *) dyn_request_scratch(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size / 2 + 1));
+        if (scratch) {
+            dyn_linearize(dyn_array);
+            dyn_stable_sort_buffer((uint8_t *) dyn_array->array, dyn_array->size, dyn_array->data_size, compare, scratch);
+            DYN_SET_SORTED(dyn_array, compare);
+            return true;
+        }
+    }
+    return false;
+}
 
-bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const object,
-                             int (*compare)(const void *, const void *)) {
-    if (dyn_array && compare && object) {
-        size_t ordered_position = 0;
-        if (dyn_array->size) {
-            while (ordered_position < dyn_array->size &&
-                    compare(object, DYN_ARRAY_POSITION(dyn_array, ordered_position)) > 0) {
-                ++ordered_position;
+bool dyn_array_sort_parallel(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *),
+                             const size_t nthreads) {
+    if (dyn_array && dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        if (nthreads > 1 && dyn_array->size >= 2 * DYN_PARALLEL_SORT_MIN_CHUNK
+                && !(DYN_IS_SORTED(dyn_array, compare) && dyn_scan_sorted(dyn_array, compare))) {
+            uint8_t *const scratch = (uint8_t *) dyn_request_scratch(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+            if (scratch) {
+                dyn_linearize(dyn_array);
+                if (dyn_parallel_sort_buffer((uint8_t *) dyn_array->array, dyn_array->size, dyn_array->data_size,
+                                             compare, nthreads, scratch)) {
+                    memcpy(dyn_array->array, scratch, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+                }
+                DYN_SET_SORTED(dyn_array, compare);
+                return true;
             }
         }
-        return dyn_shift(dyn_array, ordered_position, 1, CREATE_GAP, (void *const) object);
+        // too small to bother, already sorted, or no memory for the scratch buffer. Sorted is sorted.
+        return dyn_array_sort(dyn_array, compare);
     }
     return false;
 }
 
+bool dyn_array_sort_radix(dyn_array_t *const dyn_array, const size_t key_offset, const size_t key_width,
+                          const DYN_RADIX_FLAGS flags) {
+    if (dyn_array && dyn_array->size && DYN_WRITABLE(dyn_array)
+            && (key_width == 1 || key_width == 2 || key_width == 4 || key_width == 8)
+            && key_offset < dyn_array->data_size && key_width <= dyn_array->data_size - key_offset
+            && (!(flags & DYN_RADIX_FLOAT) || key_width == 4 || key_width == 8)
+            && !(flags & ~(DYN_RADIX_SIGNED | DYN_RADIX_FLOAT | DYN_RADIX_DESCENDING))) {
+        uint8_t *const scratch = (uint8_t *) dyn_request_scratch(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+        if (scratch) {
+            // sorted, but not by any comparator we know about
+            DYN_FLAG_UNSET(dyn_array, SORTED);
+            dyn_linearize(dyn_array);
+            if (dyn_radix_sort_buffer((uint8_t *) dyn_array->array, dyn_array->size, dyn_array->data_size,
+                                      key_offset, key_width, flags, scratch)) {
+                // odd number of passes, the result's in the scratch buffer
+                // Could just swap the buffers, but the scratch buffer is probably smaller than capacity
+                memcpy(dyn_array->array, scratch, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+            }
+            return true;
+        }
+    }
+    return false;
+}
 
-bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*func)(void *const, void *), void *arg) {
-    if (dyn_array && dyn_array->array && func) {
-        // So I just noticed we never check the data array ever
-        // Which is both unsafe and potentially undefined behavior
-        // Although we're the only ones that touch the pointer and we always validate it.
-        // So it's questionable. We'll check it here.
-        // I'm considering taking these out. Anything under our control that touches this pointer is safe
-        // Not checking it will segfault, which is good for debugging, but not so much for the end user
-        // but good for the tester. But the tester may not trigger this if it's a crazy edge case.
-        // HMMMMMMMMM...
-        uint8_t *data_walker = (uint8_t *)dyn_array->array;
-        for (size_t idx = 0; idx < dyn_array->size; ++idx, data_walker += dyn_array->data_size) {
-            func((void *const) data_walker, arg);
+bool dyn_array_nth_element(dyn_array_t *const dyn_array, const size_t nth, int (*compare)(const void *, const void *)) {
+    if (dyn_array && nth < dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        // sorted already has everything where it belongs
+        if (!DYN_IS_SORTED(dyn_array, compare)) {
+            dyn_linearize(dyn_array);
+            dyn_select_buffer((uint8_t *) dyn_array->array, dyn_array->size, nth, dyn_array->data_size, compare);
+            DYN_FLAG_UNSET(dyn_array, SORTED);
         }
         return true;
     }
     return false;
 }
 
-
-/*
-    // No return value. It either goes or it doesn't. shrink_to_fit is more of a request
-    void dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) {
-    if (dyn_array) {
-        void *new_address = realloc(dyn_array->data, DYN_ARRAY_SIZE_N_ELEMS(dyn_array, dyn_array->size));
-        if (new_address) {
-            dyn_array->data = new_address;
-            SET_FLAG(dyn_array,SHRUNK);
+bool dyn_array_partial_sort(dyn_array_t *const dyn_array, const size_t k, int (*compare)(const void *, const void *)) {
+    if (dyn_array && compare && DYN_WRITABLE(dyn_array)) {
+        if (k >= dyn_array->size) {
+            // that's all of it
+            return !dyn_array->size || dyn_array_sort(dyn_array, compare);
+        }
+        if (k && !DYN_IS_SORTED(dyn_array, compare)) {
+            // k smallest to the front with the (k-1)th in place, then sort the ones in front of it
+            dyn_linearize(dyn_array);
+            uint8_t *const base = (uint8_t *) dyn_array->array;
+            dyn_select_buffer(base, dyn_array->size, k - 1, dyn_array->data_size, compare);
+            dyn_sort_buffer(base, k - 1, dyn_array->data_size, compare);
+            DYN_FLAG_UNSET(dyn_array, SORTED);
         }
+        return true;
     }
+    return false;
+}
+
+size_t dyn_array_top_k(const dyn_array_t *const dyn_array, const size_t k, void *const objects,
+                       int (*compare)(const void *, const void *)) {
+    if (dyn_array && objects && compare) {
+        const size_t count = k < dyn_array->size ? k : dyn_array->size;
+        if (count) {
+            uint8_t *const out = (uint8_t *) objects;
+            if (DYN_IS_SORTED(dyn_array, compare)) {
+                // the biggest are the back ones
+                for (size_t idx = 0; idx < count; ++idx) {
+                    dyn_array->kernels->move(out + DYN_SIZE_N_ELEMS(dyn_array, idx),
+                                             DYN_ARRAY_AT(dyn_array, dyn_array->size - 1 - idx), dyn_array->data_size);
+                }
+                return count;
+            }
+            dyn_sorter_t sorter;
+            dyn_sorter_init(&sorter, dyn_array->data_size, compare);
+            // the array stays put, a wrapped ring is just two runs to feed through
+            const size_t first_run = dyn_array->capacity - dyn_array->head < dyn_array->size
+                                     ? dyn_array->capacity - dyn_array->head : dyn_array->size;
+            size_t filled = 0;
+            dyn_top_k_feed(&sorter, DYN_ARRAY_AT(dyn_array, 0), first_run, out, count, &filled);
+            if (first_run < dyn_array->size) {
+                dyn_top_k_feed(&sorter, DYN_ARRAY_POSITION(dyn_array, 0), dyn_array->size - first_run,
+                               out, count, &filled);
+            }
+            dyn_top_k_finish(&sorter, out, count);
+        }
+        return count;
     }
-*/
+    return 0;
+}
 
 
+bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *, const void *)) {
+    // goes in front of any equal objects, same place the old linear scan put it
+    return object && dyn_shift(dyn_array, dyn_array_lower_bound(dyn_array, object, compare), 1,
+                               CREATE_GAP, (void *const) object);
+}
 
+bool dyn_array_insert_sorted_stable(dyn_array_t *const dyn_array, const void *const object,
+                                    int (*compare)(const void *, const void *)) {
+    // goes behind any equal objects, so equal objects stay in insertion order
+    return object && dyn_shift(dyn_array, dyn_array_upper_bound(dyn_array, object, compare), 1,
+                               CREATE_GAP, (void *const) object);
+}
 
-//
-///
-// HERE BE DRAGONS
-///
-//
+size_t dyn_array_lower_bound(const dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *, const void *)) {
+    return dyn_partition_point(dyn_array, object, compare, false);
+}
 
+size_t dyn_array_upper_bound(const dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *, const void *)) {
+    return dyn_partition_point(dyn_array, object, compare, true);
+}
 
-// Checks to see if the object can handle an increase in size (and optionally increases capacity)
-bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
+bool dyn_array_equal_range(const dyn_array_t *const dyn_array, const void *const object,
+                           int (*compare)(const void *, const void *), size_t *const first, size_t *const last) {
+    if (first && last) {
+        const size_t lower = dyn_array_lower_bound(dyn_array, object, compare);
+        if (lower != SIZE_MAX) {
+            // upper can't be before lower, no need to look there again
+            // (it can't fail either, we just checked everything)
+            size_t upper = lower;
+            while (upper < dyn_array->size && compare(object, DYN_ARRAY_AT(dyn_array, upper)) == 0) {
+                // equal runs are usually short, but don't go linear if they aren't
+                if (upper - lower == 8) {
+                    upper = dyn_array_upper_bound(dyn_array, object, compare);
+                    break;
+                }
+                ++upper;
+            }
+            *first = lower;
+            *last = upper;
+            return true;
+        }
+    }
+    return false;
+}
 
-bool dyn_shift(dyn_array_t *const dyn_array, const size_t position, const size_t count, const  DYN_SHIFT_MODE mode, void *const data_location) {
-    // Shifts contents. Mode flag controls what happens and how (duh?)
-    // So, if you erase idx 2, you're filling the gap at position two
-    // [A][X][B][C][D][E]
-    //       <---- 1
-    // [A][B][C][D][E][?]
+void *dyn_array_bsearch(const dyn_array_t *const dyn_array, const void *const object,
+                        int (*compare)(const void *, const void *)) {
+    const size_t position = dyn_array_lower_bound(dyn_array, object, compare);
+    if (position != SIZE_MAX && position < dyn_array->size &&
+            compare(object, DYN_ARRAY_AT(dyn_array, position)) == 0) {
+        return DYN_ARRAY_AT(dyn_array, position);
+    }
+    return NULL;
+}
 
-    // inserting between idx 2 and 3 (between B and C) means you're moving everything from 3 down to make room
-    // (can't use traditional insert lingo (new space is following idx) because push_front can't say position -1)
-    // [A][B][C][D][E][?]
-    //       \--F
-    //        -----> 1
-    // [A][B][?][C][D][E]
-    // (and the insert, not done by this function)
-    // [A][B][F][C][D][E]
+bool dyn_array_is_sorted(const dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    if (dyn_array && compare) {
+        if (DYN_IS_SORTED(dyn_array, compare)) {
+            return true;
+        }
+        if (dyn_scan_sorted(dyn_array, compare)) {
+            // worth remembering. It's bookkeeping, the contents don't change, so the const is still honest
+            DYN_SET_SORTED((dyn_array_t *) dyn_array, compare);
+            return true;
+        }
+    }
+    return false;
+}
 
-    // the count parameter controls how many gaps are created/filled, and grows to the LEFT.
-    // Zero will result in an error (until we have error codes(?))
+void dyn_array_mark_unsorted(dyn_array_t *const dyn_array) {
+    if (dyn_array) {
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+    }
+}
 
-    // !!! WARNING !!!
-    // This function will handle capacity increases and will change the size to reflect the changes made
-    // it WILL NOT destruct objects, because we don't know when/if that should happen without adding another flag
-    // (better to do that here and have a flag?)
-    // This function will check ranges and sizes, it should be safe to pass parameters to this without checking them first.
-    // This enables us to have one function that handles error checking and will be more maintainable, hopefully
+size_t dyn_array_find(const dyn_array_t *const dyn_array, const void *const object,
+                      int (*compare)(const void *, const void *)) {
+    if (dyn_array && object && compare) {
+        if (DYN_IS_SORTED(dyn_array, compare)) {
+            // we know the order, so it's a binary search (lower bound is the first equal one, same as the scan)
+            const size_t position = dyn_partition_point(dyn_array, object, compare, false);
+            if (position < dyn_array->size && compare(object, DYN_ARRAY_AT(dyn_array, position)) == 0) {
+                return position;
+            }
+            return SIZE_MAX;
+        }
+        for (size_t idx = 0; idx < dyn_array->size; ++idx) {
+            if (compare(object, DYN_ARRAY_AT(dyn_array, idx)) == 0) {
+                return idx;
+            }
+        }
+    }
+    return SIZE_MAX;
+}
 
-    // VERSION 2.0
-    // We now take in a data_location pointer. When increasing capacity, we fill the gap from that data source
-    // When extracting objects, we place them at that location
-    // Deconstructing does not use or check that pointer
-    // if the pointer was bad, the data structure wasn't changed (unless it was deconstruction)
-    // can't const const the pointer because then we can't write to it on extract
+bool dyn_array_contains(const dyn_array_t *const dyn_array, const void *const object,
+                        int (*compare)(const void *, const void *)) {
+    return dyn_array_find(dyn_array, object, compare) != SIZE_MAX;
+}
 
 
-    if (dyn_array && count) {
-        // dyn good, count ok
-        if (mode == CREATE_GAP && data_location) {
-            // may or may not need to increase capacity.
-            // We'll ask the capacity function if we can do it.
-            // If we can, do it. If not... Too bad for the user.
-            if (position <= dyn_array->size && dyn_request_size_increase(dyn_array, count)) {
-                if (position != dyn_array->size) { // wasn't a gap at the end, we need to move data
-                    memmove(DYN_ARRAY_POSITION(dyn_array, position + count),
-                            DYN_ARRAY_POSITION(dyn_array, position),
-                            DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size - position));
-                }
-                memcpy(DYN_ARRAY_POSITION(dyn_array, position),
-                       data_location,
-                       dyn_array->data_size * count);
-                dyn_array->size += count;
-                return true;
+bool dyn_array_set_heap_arity(dyn_array_t *const dyn_array, const size_t arity) {
+    if (dyn_array && arity >= 2 && arity <= 16) {
+        dyn_array->heap_arity = arity;
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_heapify(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    if (dyn_array && compare && DYN_WRITABLE(dyn_array)) {
+        // heap order isn't sorted order
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        // bottom up, every parent gets sifted down over children that are already heaps
+        dyn_linearize(dyn_array);
+        if (dyn_array->size > 1) {
+            uint8_t *const object = (uint8_t *) dyn_request_scratch(dyn_array, dyn_array->data_size);
+            if (!object) {
+                return false;
+            }
+            for (size_t parent = (dyn_array->size - 2) / dyn_array->heap_arity + 1; parent--;) {
+                dyn_array->kernels->move(object, DYN_ARRAY_POSITION(dyn_array, parent), dyn_array->data_size);
+                const size_t hole = dyn_heap_sift_down(dyn_array, parent, object, compare);
+                dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), object, dyn_array->data_size);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_heap_push(dyn_array_t *const dyn_array, const void *const object,
+                         int (*compare)(const void *, const void *)) {
+    if (dyn_array && object && compare && DYN_WRITABLE(dyn_array)) {
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        dyn_linearize(dyn_array);
+        if (dyn_request_size_increase(dyn_array, 1)) {
+            // the new slot at the back is the hole, object only gets copied in once it knows where
+            const size_t hole = dyn_heap_sift_up(dyn_array, dyn_array->size++, (const uint8_t *) object, compare);
+            dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), (const uint8_t *) object, dyn_array->data_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dyn_array_heap_pop(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    if (dyn_array && dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        dyn_linearize(dyn_array);
+        if (dyn_array->destructor) {
+            dyn_array->destructor(dyn_array->array);
+        }
+        dyn_heap_pop_top(dyn_array, compare);
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_heap_extract(dyn_array_t *const dyn_array, void *const object,
+                            int (*compare)(const void *, const void *)) {
+    if (dyn_array && dyn_array->size && object && compare && DYN_WRITABLE(dyn_array)) {
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        dyn_linearize(dyn_array);
+        dyn_array->kernels->move((uint8_t *) object, (const uint8_t *) dyn_array->array, dyn_array->data_size);
+        dyn_heap_pop_top(dyn_array, compare);
+        return true;
+    }
+    return false;
+}
+
+void *dyn_array_heap_top(const dyn_array_t *const dyn_array) {
+    return dyn_array_front(dyn_array);
+}
+
+bool dyn_array_heap_update(dyn_array_t *const dyn_array, const size_t index,
+                           int (*compare)(const void *, const void *)) {
+    if (dyn_array && index < dyn_array->size && compare && DYN_WRITABLE(dyn_array)) {
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        dyn_linearize(dyn_array);
+        return dyn_heap_resift(dyn_array, index, compare);
+    }
+    return false;
+}
+
+
+size_t dyn_array_prune(dyn_array_t *const dyn_array, bool (*predicate)(const void *const, void *), void *arg) {
+    if (dyn_array && predicate && DYN_WRITABLE(dyn_array)) {
+        // Erasing one at a time memmoves the whole tail every time, which is O(n^2)
+        // Instead, walk it once and slide each run of keepers down as soon as we know where it ends
+        // [K][X][K][K][X][K]  ->  [K][K][K][K]
+        //     run 2 moves 1, run 3 moves 2
+        dyn_linearize(dyn_array);
+        size_t write = 0, run_start = 0;
+        for (size_t read = 0; read < dyn_array->size; ++read) {
+            if (predicate(DYN_ARRAY_POSITION(dyn_array, read), arg)) {
+                if (run_start != write && read != run_start) {
+                    memmove(DYN_ARRAY_POSITION(dyn_array, write), DYN_ARRAY_POSITION(dyn_array, run_start),
+                            DYN_SIZE_N_ELEMS(dyn_array, read - run_start));
+                }
+                write += read - run_start;
+                run_start = read + 1;
+                if (dyn_array->destructor) {
+                    dyn_array->destructor(DYN_ARRAY_POSITION(dyn_array, read));
+                }
+            }
+        }
+        // last run
+        if (run_start != write && dyn_array->size != run_start) {
+            memmove(DYN_ARRAY_POSITION(dyn_array, write), DYN_ARRAY_POSITION(dyn_array, run_start),
+                    DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size - run_start));
+        }
+        write += dyn_array->size - run_start;
+
+        const size_t removed = dyn_array->size - write;
+        dyn_array->size = write;
+        return removed;
+    }
+    return 0;
+}
+
+size_t dyn_array_unique(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    if (dyn_array && compare && DYN_WRITABLE(dyn_array)) {
+        // Same run sliding as prune, the first of each run of equals stays and joins the keepers,
+        // the rest get destructed and the keepers slide down past them
+        // [A][A][A][B][C][C][D]  ->  [A][B][C][D]
+        //  ^keep   ^keep ^keep  ^keep
+        // Comparisons only ever look at slots that haven't been moved yet
+        dyn_linearize(dyn_array);
+        size_t write = 0, run_start = 0, read = 0;
+        while (read < dyn_array->size) {
+            const size_t run_end = dyn_equal_run_end(dyn_array, read, compare);
+            if (run_end - read > 1) {
+                // duplicates, everything up to and including read stays
+                if (run_start != write) {
+                    memmove(DYN_ARRAY_POSITION(dyn_array, write), DYN_ARRAY_POSITION(dyn_array, run_start),
+                            DYN_SIZE_N_ELEMS(dyn_array, read + 1 - run_start));
+                }
+                write += read + 1 - run_start;
+                run_start = run_end;
+                if (dyn_array->destructor) {
+                    for (size_t dupe = read + 1; dupe < run_end; ++dupe) {
+                        dyn_array->destructor(DYN_ARRAY_POSITION(dyn_array, dupe));
+                    }
+                }
+            }
+            read = run_end;
+        }
+        // last run
+        if (run_start != write && dyn_array->size != run_start) {
+            memmove(DYN_ARRAY_POSITION(dyn_array, write), DYN_ARRAY_POSITION(dyn_array, run_start),
+                    DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size - run_start));
+        }
+        write += dyn_array->size - run_start;
+
+        const size_t removed = dyn_array->size - write;
+        dyn_array->size = write;
+        return removed;
+    }
+    return 0;
+}
+
+bool dyn_array_merge(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                     int (*compare)(const void *, const void *)) {
+    return dyn_merge_sorted(dst, a, b, compare, MERGE_ALL);
+}
+
+bool dyn_array_set_union(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                         int (*compare)(const void *, const void *)) {
+    return dyn_merge_sorted(dst, a, b, compare, MERGE_UNION);
+}
+
+bool dyn_array_set_intersection(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                                int (*compare)(const void *, const void *)) {
+    return dyn_merge_sorted(dst, a, b, compare, MERGE_INTERSECTION);
+}
+
+bool dyn_array_set_difference(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                              int (*compare)(const void *, const void *)) {
+    return dyn_merge_sorted(dst, a, b, compare, MERGE_DIFFERENCE);
+}
+
+bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*func)(void *const, void *), void *arg) {
+    if (dyn_array && dyn_array->array && func) {
+        // So I just noticed we never check the data array ever
+        // Which is both unsafe and potentially undefined behavior
+        // Although we're the only ones that touch the pointer and we always validate it.
+        // So it's questionable. We'll check it here.
+        // I'm considering taking these out. Anything under our control that touches this pointer is safe
+        // Not checking it will segfault, which is good for debugging, but not so much for the end user
+        // but good for the tester. But the tester may not trigger this if it's a crazy edge case.
+        // HMMMMMMMMM...
+        // func gets to change the objects, so whatever order we knew about is gone
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        // A ring may wrap, so walk up to the end of the array, then pick up again at the start
+        // (so it's two walks, the size specialized walk keeps the stride a constant)
+        const size_t front_count = dyn_array->size < dyn_array->capacity - dyn_array->head ?
+                                   dyn_array->size : dyn_array->capacity - dyn_array->head;
+        dyn_array->kernels->walk(DYN_ARRAY_POSITION(dyn_array, dyn_array->head), front_count,
+                                 dyn_array->data_size, func, arg);
+        dyn_array->kernels->walk((uint8_t *) dyn_array->array, dyn_array->size - front_count,
+                                 dyn_array->data_size, func, arg);
+        return true;
+    }
+    return false;
+}
+
+
+bool dyn_array_for_each_span(dyn_array_t *const dyn_array, void (*func)(void *const, const size_t, void *), void *arg,
+                             const size_t max_span) {
+    if (dyn_array && dyn_array->array && func) {
+        // same as for_each, func can reorder things behind our back
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        // No linearizing, a wrapped ring is just two runs instead of one
+        // [C][D][E][?][?][A][B]  ->  func([A][B], 2), func([C][D][E], 3)
+        const size_t span = max_span ? max_span : SIZE_MAX;
+        const size_t front_count = dyn_array->size < dyn_array->capacity - dyn_array->head ?
+                                   dyn_array->size : dyn_array->capacity - dyn_array->head;
+        const size_t runs[2][2] = {{dyn_array->head, front_count}, {0, dyn_array->size - front_count}};
+        for (size_t run = 0; run < 2; ++run) {
+            for (size_t offset = 0; offset < runs[run][1]; offset += span) {
+                const size_t count = runs[run][1] - offset < span ? runs[run][1] - offset : span;
+                func((void *const) DYN_ARRAY_POSITION(dyn_array, runs[run][0] + offset), count, arg);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+bool dyn_array_for_each_parallel(dyn_array_t *const dyn_array, void (*func)(void *const, void *), void *arg,
+                                 const size_t nthreads, const size_t grain) {
+    if (dyn_array && dyn_array->array && func) {
+        // same as for_each, func can reorder things behind our back
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+        // chunks have to be contiguous
+        dyn_linearize(dyn_array);
+        size_t bounds[DYN_PARALLEL_MAX_THREADS + 1];
+        dyn_parallel_task_t tasks[DYN_PARALLEL_MAX_THREADS];
+        const size_t chunks = dyn_parallel_bounds(dyn_array, nthreads, grain, bounds);
+        for (size_t idx = 0; idx < chunks; ++idx) {
+            tasks[idx].first = DYN_ARRAY_POSITION(dyn_array, bounds[idx]);
+            tasks[idx].last = DYN_ARRAY_POSITION(dyn_array, bounds[idx + 1]);
+            tasks[idx].data_size = dyn_array->data_size;
+            tasks[idx].kernels = dyn_array->kernels;
+            tasks[idx].func = func;
+            tasks[idx].accumulate = NULL;
+            tasks[idx].accumulator = NULL;
+            tasks[idx].arg = arg;
+        }
+        dyn_run_tasks(tasks, sizeof(dyn_parallel_task_t), chunks, &dyn_parallel_task_for_each);
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_reduce_parallel(dyn_array_t *const dyn_array, void (*accumulate)(void *const, const void *const, void *),
+                               void (*combine)(void *const, const void *const, void *), void *const result,
+                               const void *const identity, const size_t accumulator_size, void *arg,
+                               const size_t nthreads, const size_t grain) {
+    if (dyn_array && dyn_array->array && accumulate && combine && result && identity && accumulator_size) {
+        dyn_linearize(dyn_array);
+        size_t bounds[DYN_PARALLEL_MAX_THREADS + 1];
+        dyn_parallel_task_t tasks[DYN_PARALLEL_MAX_THREADS];
+        const size_t chunks = dyn_parallel_bounds(dyn_array, nthreads, grain, bounds);
+
+        // one accumulator per chunk, each on its own cache line(s)
+        const size_t stride = (accumulator_size + DYN_CACHE_LINE - 1) / DYN_CACHE_LINE * DYN_CACHE_LINE;
+        uint8_t *const accumulators = (uint8_t *) malloc(stride * chunks + DYN_CACHE_LINE);
+        if (accumulators) {
+            uint8_t *const aligned = accumulators + (DYN_CACHE_LINE - (uintptr_t) accumulators % DYN_CACHE_LINE) % DYN_CACHE_LINE;
+            for (size_t idx = 0; idx < chunks; ++idx) {
+                memcpy(aligned + idx * stride, identity, accumulator_size);
+                tasks[idx].first = DYN_ARRAY_POSITION(dyn_array, bounds[idx]);
+                tasks[idx].last = DYN_ARRAY_POSITION(dyn_array, bounds[idx + 1]);
+                tasks[idx].data_size = dyn_array->data_size;
+                tasks[idx].kernels = dyn_array->kernels;
+                tasks[idx].func = NULL;
+                tasks[idx].accumulate = accumulate;
+                tasks[idx].accumulator = aligned + idx * stride;
+                tasks[idx].arg = arg;
+            }
+            dyn_run_tasks(tasks, sizeof(dyn_parallel_task_t), chunks, &dyn_parallel_task_reduce);
+            // combined in order, so combine only has to be associative, not commutative
+            for (size_t idx = 0; idx < chunks; ++idx) {
+                combine(result, aligned + idx * stride, arg);
+            }
+            free(accumulators);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity) {
+    if (dyn_array && capacity <= DYN_MAX_CAPACITY) {
+        if (capacity <= dyn_array->capacity) {
+            // already have the room
+            return true;
+        }
+        if (dyn_resize_capacity(dyn_array, capacity)) {
+            // exactly what they asked for, which probably isn't what the growth policy would pick
+            DYN_FLAG_SET(dyn_array, SHRUNK);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) {
+    // shrink_to_fit is more of a request, if the realloc fails we still have the old (bigger) block
+    // Keeps room for one object when empty, realloc to zero is implementation-defined fun
+    if (dyn_array) {
+        // the sort scratch is dead weight until the next sort
+        dyn_free(&dyn_array->allocator, dyn_array->scratch, dyn_array->scratch_size);
+        dyn_array->scratch = NULL;
+        dyn_array->scratch_size = 0;
+        const size_t fitted_capacity = dyn_array->size ? dyn_array->size : 1;
+        if (fitted_capacity == dyn_array->capacity || dyn_resize_capacity(dyn_array, fitted_capacity)) {
+            DYN_FLAG_SET(dyn_array, SHRUNK);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dyn_array_set_growth(dyn_array_t *const dyn_array, const DYN_GROWTH_POLICY policy, const size_t max_step) {
+    if (dyn_array && (policy == DYN_GROW_DOUBLE || policy == DYN_GROW_HALF || policy == DYN_GROW_EXACT)) {
+        dyn_array->growth = policy;
+        dyn_array->max_step = max_step;
+        return true;
+    }
+    return false;
+}
+
+bool dyn_array_save(const dyn_array_t *const dyn_array, const char *const path) {
+    if (dyn_array && path) {
+        FILE *file = fopen(path, "wb");
+        if (file) {
+            dyn_file_header_t header;
+            memset(&header, 0x00, sizeof(header));
+            memcpy(header.magic, DYN_FILE_MAGIC, sizeof(header.magic));
+            header.version = DYN_FILE_VERSION;
+            header.byte_order = DYN_FILE_BYTE_ORDER;
+            header.header_size = DYN_FILE_HEADER_SIZE;
+            header.count = dyn_array->size;
+            header.data_size = dyn_array->data_size;
+            bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+            // straight out of the array, a wrapped ring is just two writes (and const stays honest)
+            if (written && dyn_array->size) {
+                dyn_file_writer_t writer = {file, dyn_array->data_size, false};
+                dyn_array_for_each_span((dyn_array_t *) dyn_array, &dyn_file_write_span, &writer, 0);
+                written = !writer.failed;
+            }
+            // a short write can hide in the buffer until close
+            if (fclose(file) == 0 && written) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+dyn_array_t *dyn_array_map(const char *const path, const DYN_MAP_FLAGS flags) {
+    if (path && !(flags & ~DYN_MAP_PRIVATE)) {
+#ifdef DYN_USE_FILE_MAP
+        const int fd = open(path, O_RDONLY);
+        if (fd >= 0) {
+            dyn_array_t *dyn_array = NULL;
+            struct stat info;
+            dyn_file_header_t header;
+            if (fstat(fd, &info) == 0 && pread(fd, &header, sizeof(header), 0) == (ssize_t) sizeof(header)
+                    && dyn_file_header_valid(&header, (size_t) info.st_size)) {
+                if (!header.count) {
+                    // nothing to map, and a zero capacity array is nothing but trouble
+                    // Still read-only if that's what was asked for, empty or not
+                    dyn_array = dyn_array_create(0, header.data_size, NULL);
+                    if (dyn_array && !(flags & DYN_MAP_PRIVATE)) {
+                        DYN_FLAG_SET(dyn_array, READ_ONLY);
+                    }
+                } else {
+                    // Private either way, so nothing we do ever makes it back to the file
+                    // Read-only maps it read-only too, so a stray write through a pointer faults instead of COWing
+                    const size_t length = DYN_FILE_HEADER_SIZE + header.count * header.data_size;
+                    const int protection = flags & DYN_MAP_PRIVATE ? PROT_READ | PROT_WRITE : PROT_READ;
+                    uint8_t *const mapping = (uint8_t *) mmap(NULL, length, protection, MAP_PRIVATE, fd, 0);
+                    if (mapping != MAP_FAILED) {
+                        dyn_array = (dyn_array_t *) dyn_default_alloc(NULL, sizeof(dyn_array_t));
+                        if (dyn_array) {
+                            dyn_init(dyn_array, header.count, header.data_size, NULL, &dyn_default_allocator);
+                            dyn_array->array = mapping + DYN_FILE_HEADER_SIZE;
+                            dyn_array->size = header.count;
+                            DYN_FLAG_SET(dyn_array, MAPPED);
+                            if (!(flags & DYN_MAP_PRIVATE)) {
+                                DYN_FLAG_SET(dyn_array, READ_ONLY);
+                            }
+                        } else {
+                            munmap(mapping, length);
+                        }
+                    }
+                }
+            }
+            // the mapping keeps its own reference to the file
+            close(fd);
+            return dyn_array;
+        }
+#else
+        // No mmap, so it's a plain old read into a plain old array. Works, just isn't free.
+        FILE *file = fopen(path, "rb");
+        if (file) {
+            dyn_array_t *dyn_array = NULL;
+            dyn_file_header_t header;
+            if (fread(&header, sizeof(header), 1, file) == 1 && fseek(file, 0, SEEK_END) == 0) {
+                const long file_size = ftell(file);
+                if (file_size >= 0 && dyn_file_header_valid(&header, (size_t) file_size)
+                        && fseek(file, DYN_FILE_HEADER_SIZE, SEEK_SET) == 0
+                        && (dyn_array = dyn_array_create(header.count, header.data_size, NULL))) {
+                    if (fread(dyn_array->array, header.data_size, header.count, file) == header.count) {
+                        dyn_array->size = header.count;
+                        if (!(flags & DYN_MAP_PRIVATE)) {
+                            DYN_FLAG_SET(dyn_array, READ_ONLY);
+                        }
+                    } else {
+                        dyn_array_destroy(dyn_array);
+                        dyn_array = NULL;
+                    }
+                }
+            }
+            fclose(file);
+            return dyn_array;
+        }
+#endif
+    }
+    return NULL;
+}
+
+
+
+
+//
+///
+// HERE BE DRAGONS
+///
+//
+
+
+bool dyn_shift(dyn_array_t *const dyn_array, const size_t position, const size_t count, const  DYN_SHIFT_MODE mode, void *const data_location) {
+    // Shifts contents. Mode flag controls what happens and how (duh?)
+    // So, if you erase idx 2, you're filling the gap at position two
+    // [A][X][B][C][D][E]
+    //       <---- 1
+    // [A][B][C][D][E][?]
+
+    // inserting between idx 2 and 3 (between B and C) means you're moving everything from 3 down to make room
+    // (can't use traditional insert lingo (new space is following idx) because push_front can't say position -1)
+    // [A][B][C][D][E][?]
+    //       \--F
+    //        -----> 1
+    // [A][B][?][C][D][E]
+    // (and the insert, not done by this function)
+    // [A][B][F][C][D][E]
+
+    // the count parameter controls how many gaps are created/filled, and grows to the LEFT.
+    // Zero will result in an error (until we have error codes(?))
+
+    // !!! WARNING !!!
+    // This function will handle capacity increases and will change the size to reflect the changes made
+    // it WILL NOT destruct objects, because we don't know when/if that should happen without adding another flag
+    // (better to do that here and have a flag?)
+    // This function will check ranges and sizes, it should be safe to pass parameters to this without checking them first.
+    // This enables us to have one function that handles error checking and will be more maintainable, hopefully
+
+    // VERSION 2.0
+    // We now take in a data_location pointer. When increasing capacity, we fill the gap from that data source
+    // When extracting objects, we place them at that location
+    // Deconstructing does not use or check that pointer
+    // if the pointer was bad, the data structure wasn't changed (unless it was deconstruction)
+    // can't const const the pointer because then we can't write to it on extract
+
+
+    if (dyn_array && count && DYN_WRITABLE(dyn_array)) {
+        // dyn good, count ok
+
+        // Removing objects never breaks the order, inserting them only might
+        // (checked up front, if the insert fails anyway we've just been a little pessimistic)
+        if (mode == CREATE_GAP && DYN_FLAG_CHECK(dyn_array, SORTED) && data_location && position <= dyn_array->size
+                && !dyn_sorted_insert_keeps_order(dyn_array, position, count, (const uint8_t *) data_location)) {
+            DYN_FLAG_UNSET(dyn_array, SORTED);
+        }
+
+        // VERSION 3.0
+        // Ring mode! Gaps at the front or back are just a matter of moving head or size, no memmove.
+        // Anything in the middle still needs the memmove, and that needs us linear first.
+        if (DYN_FLAG_CHECK(dyn_array, RING) && (position == 0 || (mode == CREATE_GAP && position == dyn_array->size)
+                || (mode != CREATE_GAP && position <= dyn_array->size && count == dyn_array->size - position))) {
+            return dyn_ring_shift(dyn_array, position, count, mode, data_location);
+        }
+        if (dyn_array->head) {
+            dyn_linearize(dyn_array);
+        }
+
+        if (mode == CREATE_GAP && data_location) {
+            // may or may not need to increase capacity.
+            // We'll ask the capacity function if we can do it.
+            // If we can, do it. If not... Too bad for the user.
+            if (position <= dyn_array->size && dyn_request_size_increase(dyn_array, count)) {
+                if (position != dyn_array->size) { // wasn't a gap at the end, we need to move data
+                    memmove(DYN_ARRAY_POSITION(dyn_array, position + count),
+                            DYN_ARRAY_POSITION(dyn_array, position),
+                            DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size - position));
+                }
+                dyn_array->kernels->copy(DYN_ARRAY_POSITION(dyn_array, position),
+                                         (const uint8_t *) data_location, count, dyn_array->data_size);
+                dyn_array->size += count;
+                return true;
             }
         } else if (mode & 0x02) { // mode = FILL_GAP_DESTRUCT || FILL_GAP
             // shrinking in size
             // nice and simple (?)
 
             // verify size and range
-            if ((position + count) <= dyn_array->size) {
+            // (written so position + count can't roll over and sneak past the check)
+            if (position <= dyn_array->size && count <= dyn_array->size - position) {
                 if (mode == FILL_GAP_DESTRUCT) {
                     if (dyn_array->destructor) { // destruct AND HAVE DESTRUCTOR
                         uint8_t *arr_pos = DYN_ARRAY_POSITION(dyn_array, position);
@@ -364,9 +1502,8 @@ bool dyn_shift(dyn_array_t *const dyn_array, const size_t position, const size_t
                     }
                 } else {
                     if (data_location) {
-                        memcpy(data_location,
-                               DYN_ARRAY_POSITION(dyn_array, position),
-                               dyn_array->data_size * count);
+                        dyn_array->kernels->copy((uint8_t *) data_location,
+                                                 DYN_ARRAY_POSITION(dyn_array, position), count, dyn_array->data_size);
                     } else {
                         return false;
                     }
@@ -389,39 +1526,1691 @@ bool dyn_shift(dyn_array_t *const dyn_array, const size_t position, const size_t
     return false;
 }
 
-bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment) {
-    // check to see if the size can be increased by the increment
-    // and increase capacity if need be
-    // average case will be perfectly fine, single increment
-    if (dyn_array) {
-        //if (!ADDITION_MAY_OVERFLOW(dyn_array->size, increment)) {
-        // increment is ok, but is the capacity?
-        if (dyn_array->capacity >= (dyn_array->size + increment)) {
-            // capacity is ok!
-            return true;
+size_t dyn_partition_point(const dyn_array_t *const dyn_array, const void *const object,
+                           int (*compare)(const void *, const void *), const bool upper) {
+    // Finds the first position the object could be inserted at without breaking the sort
+    // lower: first element where compare(object, element) <= 0 (in front of equal objects)
+    // upper: first element where compare(object, element) < 0 (behind equal objects)
+    // Returns size if there's no such element, SIZE_MAX on bad parameters
+    // The array has to be sorted by the same comparator, or you'll get an answer, just not a useful one
+
+    // Halving the length each time instead of tracking low/high means one compare per loop
+    // and no (low + high) / 2 overflow to worry about
+    if (dyn_array && object && compare) {
+        size_t base = 0, length = dyn_array->size;
+        while (length) {
+            const size_t half = length >> 1;
+            const int result = compare(object, DYN_ARRAY_AT(dyn_array, base + half));
+            if (upper ? result >= 0 : result > 0) {
+                // object goes after the middle one, throw out the front half (and the middle)
+                base += half + 1;
+                length -= half + 1;
+            } else {
+                length = half;
+            }
         }
-        // have to reallocate, is that even possible?
-        size_t needed_size = dyn_array->size + increment;
-
-        // INSERT SHRINK_TO_FIT CORRECTION HERE
-
-        if (needed_size <= DYN_MAX_CAPACITY) {
-            size_t new_capacity = dyn_array->capacity << 1;
-            while (new_capacity < needed_size) {new_capacity <<= 1;}
-
-            // we can theoretically hold this, check if we can allocate that
-            //if (!MULTIPLY_MAY_OVERFLOW(new_capacity, dyn_array->data_size)) {
-            // we won't overflow, so we can at least REQUEST this change
-            void *new_array = realloc(dyn_array->array, new_capacity * dyn_array->data_size);
-            if (new_array) {
-                // success! Wasn't that easy?
-                dyn_array->array = new_array;
-                dyn_array->capacity = new_capacity;
-                return true;
+        return base;
+    }
+    return SIZE_MAX;
+}
+
+void dyn_fill_from_back(dyn_array_t *const dyn_array, const size_t index) {
+    // One object moves no matter where the hole is, instead of the whole tail sliding down
+    // [A][B][_][D][E]  ->  [A][B][E][D]
+    // Order's gone, unless the hole was the back to begin with
+    const size_t back = dyn_array->size - 1;
+    if (index != back) {
+        dyn_array->kernels->move(DYN_ARRAY_AT(dyn_array, index), DYN_ARRAY_AT(dyn_array, back), dyn_array->data_size);
+        DYN_FLAG_UNSET(dyn_array, SORTED);
+    }
+    dyn_array->size = back;
+    if (!back) {
+        // empty, might as well start fresh at the front (same as the ring shift)
+        dyn_array->head = 0;
+    }
+}
+
+bool dyn_sorted_insert_keeps_order(const dyn_array_t *const dyn_array, const size_t position, const size_t count,
+                                   const uint8_t *const objects) {
+    // The new run has to be in order itself, and fit between its neighbors
+    // [A][B] + [C][D][E] + [F][G]  ->  B <= C, C <= D <= E, E <= F
+    int (*const compare)(const void *, const void *) = dyn_array->sorted_by;
+    const uint8_t *const last = objects + DYN_SIZE_N_ELEMS(dyn_array, count - 1);
+    if (position && compare(DYN_ARRAY_AT(dyn_array, position - 1), objects) > 0) {
+        return false;
+    }
+    for (const uint8_t *object = objects; object < last; object += dyn_array->data_size) {
+        if (compare(object, object + dyn_array->data_size) > 0) {
+            return false;
+        }
+    }
+    return position == dyn_array->size || compare(last, DYN_ARRAY_AT(dyn_array, position)) <= 0;
+}
+
+bool dyn_scan_sorted(const dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    for (size_t idx = 1; idx < dyn_array->size; ++idx) {
+        if (compare(DYN_ARRAY_AT(dyn_array, idx - 1), DYN_ARRAY_AT(dyn_array, idx)) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t dyn_equal_run_end(const dyn_array_t *const dyn_array, const size_t first,
+                         int (*compare)(const void *, const void *)) {
+    const uint8_t *const object = DYN_ARRAY_POSITION(dyn_array, first);
+    if (DYN_IS_SORTED(dyn_array, compare)) {
+        // Equal objects are all together, so gallop out 1, 2, 4... until one isn't equal,
+        // then binary search the last stride. Long runs cost log(run) compares instead of run.
+        size_t equal = first, step = 1;
+        while (step < dyn_array->size - first && compare(object, DYN_ARRAY_POSITION(dyn_array, first + step)) == 0) {
+            equal = first + step;
+            step <<= 1;
+        }
+        // (equal, different) brackets the end, different might be size
+        size_t different = step < dyn_array->size - first ? first + step : dyn_array->size;
+        while (different - equal > 1) {
+            const size_t middle = equal + (different - equal) / 2;
+            if (compare(object, DYN_ARRAY_POSITION(dyn_array, middle)) == 0) {
+                equal = middle;
+            } else {
+                different = middle;
             }
         }
+        return different;
+    }
+    size_t end = first + 1;
+    while (end < dyn_array->size && compare(object, DYN_ARRAY_POSITION(dyn_array, end)) == 0) {
+        ++end;
+    }
+    return end;
+}
+
+bool dyn_merge_sorted(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                      int (*compare)(const void *, const void *), const DYN_MERGE_MODE mode) {
+    // One pass over both, the same walk std::merge/set_union/... do
+    // Output goes straight onto the back of dst, which grows once up front to the most we could write
+    // (reserved already? then no allocation at all)
+    if (dst && a && b && compare && dst != a && dst != b && DYN_WRITABLE(dst) &&
+            a->data_size == dst->data_size && b->data_size == dst->data_size) {
+        size_t most = a->size;
+        if (mode == MERGE_ALL || mode == MERGE_UNION) {
+            if (b->size > DYN_MAX_CAPACITY - a->size) {
+                return false;
+            }
+            most += b->size;
+        } else if (mode == MERGE_INTERSECTION && b->size < most) {
+            most = b->size;
+        }
+        if (!most) {
+            return true;
+        }
+
+        // Everything in one piece. Same deal as export for the sources, contents don't change.
+        if (a->head) {
+            dyn_linearize((dyn_array_t *) a);
+        }
+        if (b->head) {
+            dyn_linearize((dyn_array_t *) b);
+        }
+        dyn_linearize(dst);
+        if (!dyn_request_size_increase(dst, most)) {
+            return false;
+        }
+
+        const size_t data_size = dst->data_size;
+        void (*const move)(uint8_t *, const uint8_t *, const size_t) = dst->kernels->move;
+        const uint8_t *left = (const uint8_t *) a->array, *right = (const uint8_t *) b->array;
+        const uint8_t *const left_end = a->size ? left + DYN_SIZE_N_ELEMS(a, a->size) : left;
+        const uint8_t *const right_end = b->size ? right + DYN_SIZE_N_ELEMS(b, b->size) : right;
+        uint8_t *const out_start = DYN_ARRAY_POSITION(dst, dst->size);
+        uint8_t *out = out_start;
+
+        while (left < left_end && right < right_end) {
+            const int order = compare(left, right);
+            if (order < 0) {
+                if (mode != MERGE_INTERSECTION) {
+                    move(out, left, data_size);
+                    out += data_size;
+                }
+                left += data_size;
+            } else if (order > 0) {
+                if (mode == MERGE_ALL || mode == MERGE_UNION) {
+                    move(out, right, data_size);
+                    out += data_size;
+                }
+                right += data_size;
+            } else {
+                // a's goes first, which is what keeps the merge stable
+                if (mode != MERGE_DIFFERENCE) {
+                    move(out, left, data_size);
+                    out += data_size;
+                }
+                left += data_size;
+                // a plain merge gets to b's on the next lap, everyone else pairs them off
+                if (mode != MERGE_ALL) {
+                    right += data_size;
+                }
+            }
+        }
+        // Whatever's left over has nothing to pair with
+        if (left < left_end && mode != MERGE_INTERSECTION) {
+            memcpy(out, left, (size_t) (left_end - left));
+            out += left_end - left;
+        }
+        if (right < right_end && (mode == MERGE_ALL || mode == MERGE_UNION)) {
+            memcpy(out, right, (size_t) (right_end - right));
+            out += right_end - right;
+        }
+
+        // Only vouch for the order if both sides were known to be sorted this way,
+        // and what we added starts no lower than what dst already ended with
+        if (out != out_start) {
+            if (DYN_IS_SORTED(a, compare) && DYN_IS_SORTED(b, compare) &&
+                    (!dst->size || (DYN_IS_SORTED(dst, compare) && compare(out_start - data_size, out_start) <= 0))) {
+                DYN_SET_SORTED(dst, compare);
+            } else {
+                DYN_FLAG_UNSET(dst, SORTED);
+            }
+        }
+        dst->size += (size_t) (out - out_start) / data_size;
+        return true;
+    }
+    return false;
+}
+
+size_t dyn_heap_sift_up(dyn_array_t *const dyn_array, size_t hole, const uint8_t *const object,
+                        int (*compare)(const void *, const void *)) {
+    while (hole) {
+        const size_t parent = (hole - 1) / dyn_array->heap_arity;
+        if (compare(DYN_ARRAY_POSITION(dyn_array, parent), object) >= 0) {
+            break;
+        }
+        dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), DYN_ARRAY_POSITION(dyn_array, parent),
+                                 dyn_array->data_size);
+        hole = parent;
+    }
+    return hole;
+}
+
+size_t dyn_heap_sift_down(dyn_array_t *const dyn_array, size_t hole, const uint8_t *const object,
+                          int (*compare)(const void *, const void *)) {
+    // Each level looks at all arity children to find the biggest, but they're side by side in memory,
+    // so a 4-ary level is one cache line where a binary heap would've been two levels (and two lines)
+    const size_t arity = dyn_array->heap_arity;
+    size_t first_child;
+    while ((first_child = hole * arity + 1) < dyn_array->size) {
+        const size_t last_child = dyn_array->size - first_child > arity ? first_child + arity : dyn_array->size;
+        uint8_t *biggest = DYN_ARRAY_POSITION(dyn_array, first_child);
+        size_t biggest_idx = first_child;
+        for (size_t child = first_child + 1; child < last_child; ++child) {
+            uint8_t *const child_ptr = DYN_ARRAY_POSITION(dyn_array, child);
+            if (compare(biggest, child_ptr) < 0) {
+                biggest = child_ptr;
+                biggest_idx = child;
+            }
+        }
+        if (compare(object, biggest) >= 0) {
+            break;
+        }
+        dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), biggest, dyn_array->data_size);
+        hole = biggest_idx;
+    }
+    return hole;
+}
+
+void dyn_heap_pop_top(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *)) {
+    // The back object is past the end once size drops, and the hole never gets that far,
+    // so it can sit right where it is while the hole sinks from the top
+    const uint8_t *const back = DYN_ARRAY_POSITION(dyn_array, --dyn_array->size);
+    if (dyn_array->size) {
+        const size_t hole = dyn_heap_sift_down(dyn_array, 0, back, compare);
+        dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), back, dyn_array->data_size);
+    }
+}
+
+bool dyn_heap_resift(dyn_array_t *const dyn_array, const size_t index, int (*compare)(const void *, const void *)) {
+    uint8_t *const object = (uint8_t *) dyn_request_scratch(dyn_array, dyn_array->data_size);
+    if (object) {
+        dyn_array->kernels->move(object, DYN_ARRAY_POSITION(dyn_array, index), dyn_array->data_size);
+        size_t hole = dyn_heap_sift_up(dyn_array, index, object, compare);
+        if (hole == index) {
+            // didn't go up, might need to go down
+            hole = dyn_heap_sift_down(dyn_array, index, object, compare);
+        }
+        dyn_array->kernels->move(DYN_ARRAY_POSITION(dyn_array, hole), object, dyn_array->data_size);
+        return true;
+    }
+    return false;
+}
+
+bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment) {
+    // check to see if the size can be increased by the increment
+    // and increase capacity if need be
+    // average case will be perfectly fine, single increment
+    if (dyn_array) {
+        // bulk inserts can ask for anything, don't let size + increment roll over
+        if (increment > DYN_MAX_CAPACITY - dyn_array->size) {
+            return false;
+        }
+        // increment is ok, but is the capacity?
+        if (dyn_array->capacity >= (dyn_array->size + increment)) {
+            // capacity is ok!
+            return true;
+        }
+        // have to reallocate, is that even possible?
+        // (we already know it fits under DYN_MAX_CAPACITY)
+        const size_t needed_size = dyn_array->size + increment;
+        size_t new_capacity = needed_size;
+
+        if (dyn_array->growth != DYN_GROW_EXACT) {
+            // SHRUNK means someone set the capacity by hand (shrink_to_fit or reserve)
+            // Growing from an arbitrary leftover capacity would make arbitrary capacities forever,
+            // so start over from the minimum and take the normal steps from there.
+            // (Also saves us from doubling a capacity of one, or zero, very slowly)
+            new_capacity = DYN_FLAG_CHECK(dyn_array, SHRUNK) ? DYN_MIN_CAPACITY : dyn_array->capacity;
+            while (new_capacity < needed_size) {
+                size_t step = dyn_array->growth == DYN_GROW_HALF ? new_capacity >> 1 : new_capacity;
+                if (step < DYN_MIN_CAPACITY) {
+                    step = DYN_MIN_CAPACITY;
+                }
+                if (dyn_array->max_step && step >= dyn_array->max_step) {
+                    // capped, so every step from here on is the same size. Skip the loop.
+                    step = dyn_array->max_step;
+                    const size_t steps = (needed_size - new_capacity + step - 1) / step;
+                    new_capacity = steps > (DYN_MAX_CAPACITY - new_capacity) / step ?
+                                   DYN_MAX_CAPACITY : new_capacity + steps * step;
+                    break;
+                }
+                if (step >= DYN_MAX_CAPACITY - new_capacity) {
+                    new_capacity = DYN_MAX_CAPACITY;
+                    break;
+                }
+                new_capacity += step;
+            }
+        }
+
+        if (dyn_resize_capacity(dyn_array, new_capacity)) {
+            // success! Wasn't that easy?
+            DYN_FLAG_UNSET(dyn_array, SHRUNK);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dyn_resize_capacity(dyn_array_t *const dyn_array, const size_t new_capacity) {
+    // the ONLY place the array gets reallocated, so growth and shrinking agree on the rules
+    if (dyn_array && new_capacity >= dyn_array->size && new_capacity && new_capacity <= DYN_MAX_CAPACITY
+            && new_capacity <= SIZE_MAX / dyn_array->data_size) {
+        if (!DYN_WRITABLE(dyn_array)) {
+            return false;
+        }
+        if (DYN_FLAG_CHECK(dyn_array, MAPPED)) {
+            return dyn_resize_mapped(dyn_array, new_capacity);
+        }
+        if (dyn_array->inline_capacity && (new_capacity <= dyn_array->inline_capacity || DYN_IS_INLINE(dyn_array))) {
+            return dyn_resize_inline(dyn_array, new_capacity);
+        }
+        const size_t old_capacity = dyn_array->capacity;
+        if (new_capacity < old_capacity && dyn_array->head) {
+            // shrinking would chop off whatever's past the new end, get it all up front first
+            dyn_linearize(dyn_array);
+        }
+        // we won't overflow, so we can at least REQUEST this change
+        void *new_array = dyn_realloc(&dyn_array->allocator, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, old_capacity),
+                                      DYN_SIZE_N_ELEMS(dyn_array, new_capacity));
+        if (new_array) {
+            dyn_array->array = new_array;
+            dyn_array->capacity = new_capacity;
+            if (dyn_array->size > old_capacity - dyn_array->head) {
+                // we're a wrapped ring and just grew. The wrapped part at the start is fine where it is,
+                // slide the front part up so it ends at the new end of the array
+                const size_t front_count = old_capacity - dyn_array->head;
+                memmove(DYN_ARRAY_POSITION(dyn_array, new_capacity - front_count),
+                        DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+                        DYN_SIZE_N_ELEMS(dyn_array, front_count));
+                dyn_array->head = new_capacity - front_count;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dyn_resize_inline(dyn_array_t *const dyn_array, const size_t new_capacity) {
+    // The buffer can't be realloc'd (or given back), so every move in or out is a straight copy
+    // Ring or not, contents land at the start of their new home
+    uint8_t *const storage = DYN_INLINE_STORAGE(dyn_array);
+    if (new_capacity <= dyn_array->inline_capacity) {
+        // it all fits in the buffer, and the buffer's there either way, so never trade it for a smaller heap block
+        if (!DYN_IS_INLINE(dyn_array)) {
+            dyn_linearize(dyn_array);
+            memcpy(storage, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+            dyn_free(&dyn_array->allocator, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+            dyn_array->array = storage;
+            dyn_array->capacity = dyn_array->inline_capacity;
+        }
+        return true;
+    }
+    // spilling out to the heap
+    void *const new_array = dyn_alloc(&dyn_array->allocator, DYN_SIZE_N_ELEMS(dyn_array, new_capacity));
+    if (new_array) {
+        dyn_linearize(dyn_array);
+        memcpy(new_array, storage, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+        dyn_array->array = new_array;
+        dyn_array->capacity = new_capacity;
+        return true;
+    }
+    return false;
+}
+
+bool dyn_resize_mapped(dyn_array_t *const dyn_array, const size_t new_capacity) {
+    // The file mapping can't grow (or be given back to the allocator), so any resize moves us onto the heap
+    // From then on we're a normal array
+    void *const new_array = dyn_alloc(&dyn_array->allocator, DYN_SIZE_N_ELEMS(dyn_array, new_capacity));
+    if (new_array) {
+        dyn_linearize(dyn_array);
+        memcpy(new_array, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+        dyn_unmap_file(dyn_array);
+        DYN_FLAG_UNSET(dyn_array, MAPPED);
+        dyn_array->array = new_array;
+        dyn_array->capacity = new_capacity;
+        return true;
+    }
+    return false;
+}
+
+void dyn_unmap_file(dyn_array_t *const dyn_array) {
+#ifdef DYN_USE_FILE_MAP
+    // capacity never changes while we're mapped, so it's still what the file held
+    munmap(((uint8_t *) dyn_array->array) - DYN_FILE_HEADER_SIZE,
+           DYN_FILE_HEADER_SIZE + DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+#else
+    (void) dyn_array;
+#endif
+}
+
+bool dyn_file_header_valid(const dyn_file_header_t *const header, const size_t file_size) {
+    return memcmp(header->magic, DYN_FILE_MAGIC, sizeof(header->magic)) == 0
+           && header->version == DYN_FILE_VERSION && header->byte_order == DYN_FILE_BYTE_ORDER
+           && header->header_size == DYN_FILE_HEADER_SIZE && header->data_size && header->data_size <= SIZE_MAX
+           && header->count <= DYN_MAX_CAPACITY && header->count <= SIZE_MAX / header->data_size
+           && file_size >= DYN_FILE_HEADER_SIZE
+           && (file_size - DYN_FILE_HEADER_SIZE) / header->data_size >= header->count;
+}
+
+void dyn_file_write_span(void *const first, const size_t count, void *writer_ptr) {
+    dyn_file_writer_t *const writer = (dyn_file_writer_t *) writer_ptr;
+    if (!writer->failed && fwrite(first, writer->data_size, count, writer->file) != count) {
+        writer->failed = true;
+    }
+}
+
+bool dyn_ring_shift(dyn_array_t *const dyn_array, const size_t position, const size_t count, const DYN_SHIFT_MODE mode, void *const data_location) {
+    // Same contract as dyn_shift, but position is always one of the ends
+    // CREATE_GAP at 0 backs head up, CREATE_GAP at size just writes past the back
+    // FILL_GAP at 0 moves head forward, FILL_GAP at size - count just drops the back
+    // [C][D][E][?][?][A][B]      push_front(F) -> [C][D][E][?][F][A][B]
+    //           ^tail    ^head                             ^head
+    // Nothing in the middle ever moves. Copies in and out may wrap, so they happen in (at most) two pieces.
+
+    uint8_t *user_data = (uint8_t *) data_location;
+    if (mode == CREATE_GAP) {
+        if (!data_location || !dyn_request_size_increase(dyn_array, count)) {
+            return false;
+        }
+        // (capacity may have changed, figure out head after growing)
+        // (an empty array counts as a push at the back, no reason to start out wrapped)
+        if (position == 0 && dyn_array->size) {
+            dyn_array->head = count <= dyn_array->head ? dyn_array->head - count
+                              : dyn_array->capacity - (count - dyn_array->head);
+        }
+        dyn_array->size += count;
+    } else if (mode & 0x02) {
+        if (position > dyn_array->size || count > dyn_array->size - position
+                || (mode == FILL_GAP && !data_location)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    // walk the gap (or the objects leaving), one physical run at a time
+    for (size_t done = 0; done < count;) {
+        const size_t slot = DYN_ARRAY_SLOT(dyn_array, position + done);
+        const size_t run = count - done < dyn_array->capacity - slot ? count - done : dyn_array->capacity - slot;
+        if (mode == CREATE_GAP) {
+            dyn_array->kernels->copy(DYN_ARRAY_POSITION(dyn_array, slot), user_data + DYN_SIZE_N_ELEMS(dyn_array, done),
+                                     run, dyn_array->data_size);
+        } else if (mode == FILL_GAP) {
+            dyn_array->kernels->copy(user_data + DYN_SIZE_N_ELEMS(dyn_array, done), DYN_ARRAY_POSITION(dyn_array, slot),
+                                     run, dyn_array->data_size);
+        } else if (dyn_array->destructor) {
+            uint8_t *arr_pos = DYN_ARRAY_POSITION(dyn_array, slot);
+            for (size_t total = run; total; --total, arr_pos += dyn_array->data_size) {
+                dyn_array->destructor(arr_pos);
+            }
+        }
+        done += run;
+    }
+
+    if (mode != CREATE_GAP) {
+        if (position == 0) {
+            dyn_array->head = DYN_ARRAY_SLOT(dyn_array, count);
+        }
+        dyn_array->size -= count;
+        if (dyn_array->size == 0) {
+            // empty, might as well start fresh at the front
+            dyn_array->head = 0;
+        }
+    }
+    return true;
+}
+
+void dyn_linearize(dyn_array_t *const dyn_array) {
+    // Ring contents live in up to two runs, the front run [head, capacity) and the wrapped run [0, tail)
+    // [C][D][?][?][A][B]  ->  [A][B][C][D][?][?]
+    // Not wrapped is easy, one memmove. Wrapped means a rotation.
+    if (dyn_array && dyn_array->head) {
+        const size_t front_count = dyn_array->capacity - dyn_array->head;
+        if (dyn_array->size <= front_count) {
+            memmove(dyn_array->array, DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+                    DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+        } else {
+            const size_t wrapped_count = dyn_array->size - front_count;
+            // park the smaller run somewhere else, move the bigger one into place, drop the smaller one back in
+            const size_t parked_count = front_count < wrapped_count ? front_count : wrapped_count;
+            uint8_t *parking = (uint8_t *) malloc(DYN_SIZE_N_ELEMS(dyn_array, parked_count));
+            if (parking) {
+                if (parked_count == front_count) {
+                    memcpy(parking, DYN_ARRAY_POSITION(dyn_array, dyn_array->head), DYN_SIZE_N_ELEMS(dyn_array, front_count));
+                    memmove(DYN_ARRAY_POSITION(dyn_array, front_count), dyn_array->array,
+                            DYN_SIZE_N_ELEMS(dyn_array, wrapped_count));
+                    memcpy(dyn_array->array, parking, DYN_SIZE_N_ELEMS(dyn_array, front_count));
+                } else {
+                    memcpy(parking, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, wrapped_count));
+                    memmove(dyn_array->array, DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+                            DYN_SIZE_N_ELEMS(dyn_array, front_count));
+                    memcpy(DYN_ARRAY_POSITION(dyn_array, front_count), parking, DYN_SIZE_N_ELEMS(dyn_array, wrapped_count));
+                }
+                free(parking);
+            } else {
+                // No memory to spare. Slide the front run down against the wrapped run, then rotate in place
+                // with the old three reversals trick. Slow (byte swaps) but it can't fail.
+                memmove(DYN_ARRAY_POSITION(dyn_array, wrapped_count), DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+                        DYN_SIZE_N_ELEMS(dyn_array, front_count));
+                dyn_reverse(dyn_array, 0, wrapped_count);
+                dyn_reverse(dyn_array, wrapped_count, dyn_array->size);
+                dyn_reverse(dyn_array, 0, dyn_array->size);
+            }
+        }
+        dyn_array->head = 0;
+    }
+}
+
+void dyn_reverse(dyn_array_t *const dyn_array, const size_t first, const size_t last) {
+    // reverses the objects in physical slots [first, last)
+    if (last - first > 1) {
+        uint8_t *low = DYN_ARRAY_POSITION(dyn_array, first), *high = DYN_ARRAY_POSITION(dyn_array, last - 1);
+        for (; low < high; high -= dyn_array->data_size << 1) {
+            for (size_t byte = 0; byte < dyn_array->data_size; ++byte, ++low, ++high) {
+                const uint8_t temp = *low;
+                *low = *high;
+                *high = temp;
+            }
+        }
+    }
+}
+
+void dyn_init(dyn_array_t *const dyn_array, const size_t capacity, const size_t data_type_size,
+              void (*destruct_func)(void *), const dyn_allocator_t *const allocator) {
+    dyn_array->flags = NONE;
+    dyn_array->growth = DYN_GROW_DOUBLE;
+    dyn_array->max_step = 0;
+    dyn_array->head = 0;
+    dyn_array->capacity = capacity;
+    dyn_array->size = 0;
+    dyn_array->data_size = data_type_size;
+    dyn_array->array = NULL;
+    dyn_array->destructor = destruct_func;
+    dyn_array->kernels = dyn_select_kernels(data_type_size);
+    dyn_array->scratch = NULL;
+    dyn_array->scratch_size = 0;
+    dyn_array->allocator = *allocator;
+    dyn_array->inline_capacity = 0;
+    dyn_array->heap_arity = 2;
+    dyn_array->sorted_by = NULL;
+}
+
+void *dyn_alloc(const dyn_allocator_t *const allocator, const size_t bytes) {
+    return allocator->alloc(allocator->context, bytes);
+}
+
+void *dyn_realloc(const dyn_allocator_t *const allocator, void *const ptr, const size_t old_bytes, const size_t new_bytes) {
+    if (allocator->realloc) {
+        return allocator->realloc(allocator->context, ptr, old_bytes, new_bytes);
+    }
+    // no realloc, do it the long way. Old block stays put if we can't get a new one, same as realloc
+    void *const new_ptr = allocator->alloc(allocator->context, new_bytes);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+        dyn_free(allocator, ptr, old_bytes);
+    }
+    return new_ptr;
+}
+
+void dyn_free(const dyn_allocator_t *const allocator, void *const ptr, const size_t bytes) {
+    // no free callback means the allocator cleans up after itself (arenas and such)
+    if (ptr && allocator->free) {
+        allocator->free(allocator->context, ptr, bytes);
+    }
+}
+
+void dyn_advise_huge(void *const ptr, const size_t bytes) {
+    // Fewer TLB misses walking a huge array, and fewer page faults filling one
+#if defined(DYN_USE_MMAP) && defined(MADV_HUGEPAGE)
+    madvise(ptr, bytes, MADV_HUGEPAGE);
+#else
+    (void) ptr;
+    (void) bytes;
+#endif
+}
+
+//
+///
+// PARALLEL
+///
+//
+
+void dyn_run_tasks(void *const tasks, const size_t task_size, const size_t count, void *(*func)(void *)) {
+    // one thread each, the calling thread takes the last one
+    // If a thread won't start, its task just runs here instead. Slower, still correct.
+    pthread_t threads[2 * DYN_PARALLEL_MAX_THREADS];
+    bool started[2 * DYN_PARALLEL_MAX_THREADS];
+    uint8_t *const task_bytes = (uint8_t *) tasks;
+    for (size_t idx = 0; idx + 1 < count; ++idx) {
+        started[idx] = pthread_create(threads + idx, NULL, func, task_bytes + idx * task_size) == 0;
+        if (!started[idx]) {
+            func(task_bytes + idx * task_size);
+        }
+    }
+    func(task_bytes + (count - 1) * task_size);
+    for (size_t idx = 0; idx + 1 < count; ++idx) {
+        if (started[idx]) {
+            pthread_join(threads[idx], NULL);
+        }
+    }
+}
+
+size_t dyn_parallel_bounds(const dyn_array_t *const dyn_array, size_t nthreads, size_t grain, size_t *const bounds) {
+    // Even split, then every inner boundary slides up to the next object that starts a cache line
+    // (if there is one within a line's worth of objects, odd sizes on odd addresses may not line up)
+    // so two threads never write to the same line
+    if (!grain) {
+        grain = DYN_PARALLEL_DEFAULT_GRAIN;
+    }
+    if (nthreads > DYN_PARALLEL_MAX_THREADS) {
+        nthreads = DYN_PARALLEL_MAX_THREADS;
+    }
+    if (nthreads > dyn_array->size / grain) {
+        nthreads = dyn_array->size / grain;
+    }
+    if (!nthreads) {
+        nthreads = 1;
+    }
+    bounds[0] = 0;
+    for (size_t idx = 1; idx < nthreads; ++idx) {
+        size_t bound = dyn_array->size / nthreads * idx;
+        // never looks past the end, not even to form the pointer
+        for (size_t step = 0; step < DYN_CACHE_LINE && bound + step <= dyn_array->size; ++step) {
+            if (!((uintptr_t) DYN_ARRAY_POSITION(dyn_array, bound + step) % DYN_CACHE_LINE)) {
+                bound += step;
+                break;
+            }
+        }
+        bounds[idx] = bound < bounds[idx - 1] ? bounds[idx - 1] : bound;
+    }
+    bounds[nthreads] = dyn_array->size;
+    return nthreads;
+}
+
+void *dyn_parallel_task_for_each(void *task_ptr) {
+    const dyn_parallel_task_t *const task = (const dyn_parallel_task_t *) task_ptr;
+    task->kernels->walk(task->first, (size_t)(task->last - task->first) / task->data_size, task->data_size,
+                        task->func, task->arg);
+    return NULL;
+}
+
+void *dyn_parallel_task_reduce(void *task_ptr) {
+    const dyn_parallel_task_t *const task = (const dyn_parallel_task_t *) task_ptr;
+    for (const uint8_t *walker = task->first; walker < task->last; walker += task->data_size) {
+        task->accumulate(task->accumulator, walker, task->arg);
+    }
+    return NULL;
+}
+
+//
+///
+// KERNELS
+///
+//
+
+// Everything that copies, swaps or walks objects one at a time goes through one of these.
+// The fixed sizes compile down to a couple of register moves and a constant stride,
+// generic takes the size at runtime like everything used to.
+// size is only used by the generic ones, it's there so they all fit the same pointer type
+#define DYN_KERNELS(bytes)                                                                             \
+    static void dyn_swap_##bytes(uint8_t *a, uint8_t *b, const size_t size) {                          \
+        uint8_t temp[bytes];                                                                           \
+        (void) size;                                                                                   \
+        memcpy(temp, a, bytes);                                                                        \
+        memcpy(a, b, bytes);                                                                           \
+        memcpy(b, temp, bytes);                                                                        \
+    }                                                                                                  \
+    static void dyn_move_##bytes(uint8_t *dst, const uint8_t *src, const size_t size) {               \
+        (void) size;                                                                                   \
+        memcpy(dst, src, bytes);                                                                       \
+    }                                                                                                  \
+    static void dyn_copy_##bytes(uint8_t *dst, const uint8_t *src, const size_t count, const size_t size) { \
+        (void) size;                                                                                   \
+        /* one object is the push/pop/extract case, worth its own fixed size copy */                  \
+        if (count == 1) {                                                                              \
+            memcpy(dst, src, bytes);                                                                   \
+        } else {                                                                                       \
+            memcpy(dst, src, count * bytes);                                                           \
+        }                                                                                              \
+    }                                                                                                  \
+    static void dyn_walk_##bytes(uint8_t *first, size_t count, const size_t size,                     \
+                                 void (*func)(void *const, void *), void *arg) {                      \
+        (void) size;                                                                                   \
+        for (; count; --count, first += bytes) {                                                       \
+            func((void *const) first, arg);                                                            \
+        }                                                                                              \
+    }
+
+DYN_KERNELS(1)
+DYN_KERNELS(2)
+DYN_KERNELS(4)
+DYN_KERNELS(8)
+DYN_KERNELS(16)
+DYN_KERNELS(32)
+
+static void dyn_swap_generic(uint8_t *a, uint8_t *b, size_t size) {
+    // big objects get swapped in chunks so the temp stays on the stack
+    uint8_t temp[64];
+    while (size) {
+        const size_t chunk = size < sizeof(temp) ? size : sizeof(temp);
+        memcpy(temp, a, chunk);
+        memcpy(a, b, chunk);
+        memcpy(b, temp, chunk);
+        a += chunk;
+        b += chunk;
+        size -= chunk;
+    }
+}
+
+static void dyn_move_generic(uint8_t *dst, const uint8_t *src, const size_t size) {
+    memcpy(dst, src, size);
+}
+
+static void dyn_copy_generic(uint8_t *dst, const uint8_t *src, const size_t count, const size_t size) {
+    memcpy(dst, src, count * size);
+}
+
+static void dyn_walk_generic(uint8_t *first, size_t count, const size_t size,
+                             void (*func)(void *const, void *), void *arg) {
+    for (; count; --count, first += size) {
+        func((void *const) first, arg);
+    }
+}
+
+#define DYN_KERNEL_TABLE(bytes) {&dyn_swap_##bytes, &dyn_move_##bytes, &dyn_copy_##bytes, &dyn_walk_##bytes}
+
+static const dyn_kernels_t dyn_kernel_tables[7] = {
+    DYN_KERNEL_TABLE(1), DYN_KERNEL_TABLE(2), DYN_KERNEL_TABLE(4), DYN_KERNEL_TABLE(8),
+    DYN_KERNEL_TABLE(16), DYN_KERNEL_TABLE(32), DYN_KERNEL_TABLE(generic)};
+
+const dyn_kernels_t *dyn_select_kernels(const size_t data_size) {
+    switch (data_size) {
+        case 1:
+            return dyn_kernel_tables;
+        case 2:
+            return dyn_kernel_tables + 1;
+        case 4:
+            return dyn_kernel_tables + 2;
+        case 8:
+            return dyn_kernel_tables + 3;
+        case 16:
+            return dyn_kernel_tables + 4;
+        case 32:
+            return dyn_kernel_tables + 5;
+        default:
+            return dyn_kernel_tables + 6;
+    }
+}
+
+//
+///
+// SORT ENGINE
+///
+//
+
+void dyn_sorter_init(dyn_sorter_t *const sorter, const size_t data_size, int (*compare)(const void *, const void *)) {
+    const dyn_kernels_t *const kernels = dyn_select_kernels(data_size);
+    sorter->size = data_size;
+    sorter->compare = compare;
+    sorter->swap = kernels->swap;
+    sorter->move = kernels->move;
+}
+
+// Under this, insertion sort wins
+#define DYN_SORT_INSERTION_THRESHOLD 24
+// Over this, pivot is the median of three medians of three instead of just median of three
+#define DYN_SORT_NINTHER_THRESHOLD 128
+// How many objects partial insertion sort can move before it gives up on the range being nearly sorted
+#define DYN_SORT_PARTIAL_INSERTION_LIMIT 8
+
+#define SORT_AT(base, idx) ((base) + (idx) * sorter->size)
+#define SORT_LESS(a, b) (sorter->compare((a), (b)) < 0)
+#define SORT_SWAP(base, x, y) sorter->swap(SORT_AT(base, x), SORT_AT(base, y), sorter->size)
+
+static void dyn_insertion_sort(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count) {
+    // strictly less, so equal objects never pass each other. The stable sort counts on that.
+    for (size_t idx = 1; idx < count; ++idx) {
+        for (size_t walker = idx; walker && SORT_LESS(SORT_AT(base, walker), SORT_AT(base, walker - 1)); --walker) {
+            SORT_SWAP(base, walker, walker - 1);
+        }
+    }
+}
+
+// Insertion sort that bails out if it has to move too much
+// returns true if the range is sorted, false if it gave up (range is still a permutation of what it was)
+static bool dyn_partial_insertion_sort(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count) {
+    size_t moves = 0;
+    for (size_t idx = 1; idx < count; ++idx) {
+        size_t walker = idx;
+        for (; walker && SORT_LESS(SORT_AT(base, walker), SORT_AT(base, walker - 1)); --walker) {
+            SORT_SWAP(base, walker, walker - 1);
+        }
+        moves += idx - walker;
+        if (moves > DYN_SORT_PARTIAL_INSERTION_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sorts the three objects so a <= b <= c
+static void dyn_sort3(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t a, const size_t b, const size_t c) {
+    if (SORT_LESS(SORT_AT(base, b), SORT_AT(base, a))) {
+        SORT_SWAP(base, a, b);
+    }
+    if (SORT_LESS(SORT_AT(base, c), SORT_AT(base, b))) {
+        SORT_SWAP(base, b, c);
+        if (SORT_LESS(SORT_AT(base, b), SORT_AT(base, a))) {
+            SORT_SWAP(base, a, b);
+        }
+    }
+}
+
+static void dyn_sift_down(const dyn_sorter_t *const sorter, uint8_t *const base, size_t root, const size_t count) {
+    for (size_t child = 2 * root + 1; child < count; root = child, child = 2 * root + 1) {
+        if (child + 1 < count && SORT_LESS(SORT_AT(base, child), SORT_AT(base, child + 1))) {
+            ++child;
+        }
+        if (!SORT_LESS(SORT_AT(base, root), SORT_AT(base, child))) {
+            return;
+        }
+        SORT_SWAP(base, root, child);
+    }
+}
+
+static void dyn_heap_sort(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count) {
+    for (size_t idx = count / 2; idx--;) {
+        dyn_sift_down(sorter, base, idx, count);
+    }
+    for (size_t end = count; end-- > 1;) {
+        SORT_SWAP(base, 0, end);
+        dyn_sift_down(sorter, base, 0, end);
+    }
+}
+
+// Partitions around the pivot at base[0], objects equal to the pivot go right
+// Returns the pivot's final position, already_partitioned is set if nothing had to be swapped
+// Needs something not less than the pivot past the start of the range (pivot selection makes sure of that)
+static size_t dyn_partition_right(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count,
+                                  bool *const already_partitioned) {
+    const uint8_t *const pivot = base;
+    size_t first = 1, last = count;
+
+    while (SORT_LESS(SORT_AT(base, first), pivot)) {
+        ++first;
+    }
+    if (first == 1) {
+        // nothing stops the scan from the right if everything's less than the pivot
+        while (first < last && !SORT_LESS(SORT_AT(base, --last), pivot)) {}
+    } else {
+        while (!SORT_LESS(SORT_AT(base, --last), pivot)) {}
+    }
+
+    *already_partitioned = first >= last;
+
+    while (first < last) {
+        SORT_SWAP(base, first, last);
+        while (SORT_LESS(SORT_AT(base, ++first), pivot)) {}
+        while (!SORT_LESS(SORT_AT(base, --last), pivot)) {}
+    }
+
+    const size_t pivot_position = first - 1;
+    SORT_SWAP(base, 0, pivot_position);
+    return pivot_position;
+}
+
+// Partitions around the pivot at base[0], objects equal to the pivot go LEFT
+// Only used when the pivot equals the object before the range, meaning nothing in the range
+// is less than it. Everything equal lands on the left and never gets looked at again.
+static size_t dyn_partition_left(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count) {
+    const uint8_t *const pivot = base;
+    size_t first = 0, last = count;
+
+    while (SORT_LESS(pivot, SORT_AT(base, --last))) {}
+    if (last + 1 == count) {
+        while (first < last && !SORT_LESS(pivot, SORT_AT(base, ++first))) {}
+    } else {
+        while (!SORT_LESS(pivot, SORT_AT(base, ++first))) {}
+    }
+
+    while (first < last) {
+        SORT_SWAP(base, first, last);
+        while (SORT_LESS(pivot, SORT_AT(base, --last))) {}
+        while (!SORT_LESS(pivot, SORT_AT(base, ++first))) {}
+    }
+
+    SORT_SWAP(base, 0, last);
+    return last;
+}
+
+// Median of 3 (or 9, for big ranges) ends up at base[0], with something not less than it at the end
+static void dyn_choose_pivot(const dyn_sorter_t *const sorter, uint8_t *const base, const size_t count) {
+    const size_t half = count / 2;
+    if (count > DYN_SORT_NINTHER_THRESHOLD) {
+        dyn_sort3(sorter, base, 0, half, count - 1);
+        dyn_sort3(sorter, base, 1, half - 1, count - 2);
+        dyn_sort3(sorter, base, 2, half + 1, count - 3);
+        dyn_sort3(sorter, base, half - 1, half, half + 1);
+        SORT_SWAP(base, 0, half);
+    } else {
+        dyn_sort3(sorter, base, half, 0, count - 1);
+    }
+}
+
+void dyn_pdqsort(const dyn_sorter_t *const sorter, uint8_t *base, size_t count, size_t bad_allowed, bool leftmost) {
+    // Pattern-defeating quicksort (Orson Peters), the short version:
+    //  - median of 3 (or 9) pivots
+    //  - if the pivot equals the object before this range, everything equal to it gets lumped together
+    //    on the left and skipped, so lots of duplicates go linear instead of quadratic
+    //  - a partition that swapped nothing gets a (bounded) insertion sort, so sorted input is linear
+    //  - lopsided partitions shuffle a few objects around to break up whatever pattern caused them,
+    //    and if that keeps happening we give up and heap sort. Worst case is n log n no matter what.
+    // Recurses on the smaller side, loops on the bigger one, so the stack stays at log n
+    while (true) {
+        if (count < DYN_SORT_INSERTION_THRESHOLD) {
+            dyn_insertion_sort(sorter, base, count);
+            return;
+        }
+
+        dyn_choose_pivot(sorter, base, count);
+
+        // base[-1] is the previous pivot, nothing here is less than it
+        if (!leftmost && !SORT_LESS(base - sorter->size, base)) {
+            const size_t skip = dyn_partition_left(sorter, base, count) + 1;
+            base = SORT_AT(base, skip);
+            count -= skip;
+            continue;
+        }
+
+        bool already_partitioned = false;
+        const size_t pivot_position = dyn_partition_right(sorter, base, count, &already_partitioned);
+        const size_t left_count = pivot_position, right_count = count - pivot_position - 1;
+        uint8_t *const right = SORT_AT(base, pivot_position + 1);
+
+        if (left_count < count / 8 || right_count < count / 8) {
+            if (--bad_allowed == 0) {
+                dyn_heap_sort(sorter, base, count);
+                return;
+            }
+            if (left_count >= DYN_SORT_INSERTION_THRESHOLD) {
+                const size_t quarter = left_count / 4;
+                SORT_SWAP(base, 0, quarter);
+                SORT_SWAP(base, pivot_position - 1, pivot_position - quarter);
+                if (left_count > DYN_SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(base, 1, quarter + 1);
+                    SORT_SWAP(base, 2, quarter + 2);
+                    SORT_SWAP(base, pivot_position - 2, pivot_position - quarter - 1);
+                    SORT_SWAP(base, pivot_position - 3, pivot_position - quarter - 2);
+                }
+            }
+            if (right_count >= DYN_SORT_INSERTION_THRESHOLD) {
+                const size_t quarter = right_count / 4;
+                SORT_SWAP(right, 0, quarter);
+                SORT_SWAP(right, right_count - 1, right_count - quarter);
+                if (right_count > DYN_SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(right, 1, quarter + 1);
+                    SORT_SWAP(right, 2, quarter + 2);
+                    SORT_SWAP(right, right_count - 2, right_count - quarter - 1);
+                    SORT_SWAP(right, right_count - 3, right_count - quarter - 2);
+                }
+            }
+        } else if (already_partitioned && dyn_partial_insertion_sort(sorter, base, left_count)
+                   && dyn_partial_insertion_sort(sorter, right, right_count)) {
+            return;
+        }
+
+        if (left_count < right_count) {
+            dyn_pdqsort(sorter, base, left_count, bad_allowed, leftmost);
+            base = right;
+            count = right_count;
+            leftmost = false;
+        } else {
+            dyn_pdqsort(sorter, right, right_count, bad_allowed, false);
+            count = left_count;
+        }
+    }
+}
+
+void dyn_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                     int (*compare)(const void *, const void *)) {
+    dyn_sorter_t sorter;
+    dyn_sorter_init(&sorter, data_size, compare);
+    // bad partitions allowed before heap sort takes over, log2(n)
+    size_t bad_allowed = 1;
+    for (size_t walker = count; walker >>= 1;) {
+        ++bad_allowed;
+    }
+    dyn_pdqsort(&sorter, base, count, bad_allowed, true);
+}
+
+void dyn_select(const dyn_sorter_t *const sorter, uint8_t *base, size_t count, size_t nth, size_t bad_allowed, bool leftmost) {
+    // Introselect: pdqsort's pivots and partitions, but only ever follow the side nth is on
+    // Linear on average, and if partitions keep coming out lopsided the rest gets heap sorted,
+    // so it's never worse than n log n
+    while (true) {
+        if (count < DYN_SORT_INSERTION_THRESHOLD) {
+            dyn_insertion_sort(sorter, base, count);
+            return;
+        }
+
+        dyn_choose_pivot(sorter, base, count);
+
+        // same duplicate trick as the sort, everything equal to the pivot lands on the left
+        if (!leftmost && !SORT_LESS(base - sorter->size, base)) {
+            const size_t skip = dyn_partition_left(sorter, base, count) + 1;
+            if (nth < skip) {
+                // all equal, so all where they belong
+                return;
+            }
+            base = SORT_AT(base, skip);
+            count -= skip;
+            nth -= skip;
+            continue;
+        }
+
+        bool already_partitioned = false;
+        const size_t pivot_position = dyn_partition_right(sorter, base, count, &already_partitioned);
+        if (nth == pivot_position) {
+            return;
+        }
+        if ((pivot_position < count / 8 || count - pivot_position - 1 < count / 8) && --bad_allowed == 0) {
+            dyn_heap_sort(sorter, base, count);
+            return;
+        }
+        if (nth < pivot_position) {
+            count = pivot_position;
+        } else {
+            base = SORT_AT(base, pivot_position + 1);
+            count -= pivot_position + 1;
+            nth -= pivot_position + 1;
+            leftmost = false;
+        }
+    }
+}
+
+void dyn_select_buffer(uint8_t *const base, const size_t count, const size_t nth, const size_t data_size,
+                       int (*compare)(const void *, const void *)) {
+    dyn_sorter_t sorter;
+    dyn_sorter_init(&sorter, data_size, compare);
+    // same budget as the sort
+    size_t bad_allowed = 1;
+    for (size_t walker = count; walker >>= 1;) {
+        ++bad_allowed;
+    }
+    dyn_select(&sorter, base, count, nth, bad_allowed, true);
+}
+
+// dyn_sift_down, upside down. Smallest on top.
+static void dyn_min_sift_down(const dyn_sorter_t *const sorter, uint8_t *const base, size_t root, const size_t count) {
+    for (size_t child = 2 * root + 1; child < count; root = child, child = 2 * root + 1) {
+        if (child + 1 < count && SORT_LESS(SORT_AT(base, child + 1), SORT_AT(base, child))) {
+            ++child;
+        }
+        if (!SORT_LESS(SORT_AT(base, child), SORT_AT(base, root))) {
+            return;
+        }
+        SORT_SWAP(base, root, child);
+    }
+}
+
+void dyn_top_k_feed(const dyn_sorter_t *const sorter, const uint8_t *source, size_t count,
+                    uint8_t *const heap, const size_t k, size_t *const filled) {
+    // The heap's top is the smallest of the k biggest so far, anything bigger replaces it
+    // Everything else costs one compare, so it's n compares plus a log k sift for each one that gets in
+    for (; count; --count, source += sorter->size) {
+        if (*filled < k) {
+            sorter->move(SORT_AT(heap, *filled), source, sorter->size);
+            if (++*filled == k) {
+                for (size_t idx = k / 2; idx--;) {
+                    dyn_min_sift_down(sorter, heap, idx, k);
+                }
+            }
+        } else if (SORT_LESS(heap, source)) {
+            sorter->move(heap, source, sorter->size);
+            dyn_min_sift_down(sorter, heap, 0, k);
+        }
+    }
+}
+
+void dyn_top_k_finish(const dyn_sorter_t *const sorter, uint8_t *const heap, const size_t k) {
+    // heap sort, but smallest to the back, so it comes out biggest first
+    for (size_t end = k; end-- > 1;) {
+        SORT_SWAP(heap, 0, end);
+        dyn_min_sift_down(sorter, heap, 0, end);
+    }
+}
+
+// Binary search for the first object in [0, count) the test object should go in front of
+// upper == false: first object not less than it, upper == true: first object greater than it
+static size_t dyn_sort_bound(const dyn_sorter_t *const sorter, const uint8_t *const base, size_t count,
+                             const uint8_t *const object, const bool upper) {
+    size_t first = 0;
+    while (count) {
+        const size_t step = count / 2;
+        const int result = sorter->compare(SORT_AT(base, first + step), object);
+        if (upper ? result <= 0 : result < 0) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+// Merges the sorted runs [0, middle) and [middle, count), stable
+// scratch needs room for the smaller of the two runs
+static void dyn_merge(const dyn_sorter_t *const sorter, uint8_t *base, size_t middle, size_t count, uint8_t *const scratch) {
+    // already in order? Happens a lot with real data, and it's one compare.
+    if (!SORT_LESS(SORT_AT(base, middle), SORT_AT(base, middle - 1))) {
+        return;
+    }
+    // anything on the left not greater than the right's first object is already home,
+    // and so is anything on the right not less than the left's last object
+    const size_t skip = dyn_sort_bound(sorter, base, middle, SORT_AT(base, middle), true);
+    base = SORT_AT(base, skip);
+    middle -= skip;
+    count -= skip;
+    count = middle + dyn_sort_bound(sorter, SORT_AT(base, middle), count - middle, SORT_AT(base, middle - 1), false);
+
+    const size_t size = sorter->size;
+    if (middle <= count - middle) {
+        // left run to scratch, merge front to back. Ties go to the left, that's the stable part.
+        memcpy(scratch, base, middle * size);
+        uint8_t *left = scratch, *const left_end = scratch + middle * size;
+        uint8_t *right = SORT_AT(base, middle), *const right_end = SORT_AT(base, count);
+        uint8_t *out = base;
+        while (left < left_end && right < right_end) {
+            if (SORT_LESS(right, left)) {
+                sorter->move(out, right, size);
+                right += size;
+            } else {
+                sorter->move(out, left, size);
+                left += size;
+            }
+            out += size;
+        }
+        memcpy(out, left, left_end - left);
+    } else {
+        // right run to scratch, merge back to front. Ties go to the right this time.
+        memcpy(scratch, SORT_AT(base, middle), (count - middle) * size);
+        uint8_t *left = SORT_AT(base, middle), *right = scratch + (count - middle) * size;
+        uint8_t *out = SORT_AT(base, count);
+        while (left > base && right > scratch) {
+            out -= size;
+            if (SORT_LESS(right - size, left - size)) {
+                left -= size;
+                sorter->move(out, left, size);
+            } else {
+                right -= size;
+                sorter->move(out, right, size);
+            }
+        }
+        // left ran out first, or there's nothing left over
+        memcpy(base, scratch, right - scratch);
+    }
+}
+
+// Run length the stable sort insertion sorts before it starts merging
+#define DYN_SORT_RUN_LENGTH 16
+
+void dyn_stable_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                            int (*compare)(const void *, const void *), uint8_t *const scratch) {
+    // Bottom up merge sort: insertion sort small runs, then merge pairs of runs, doubling each pass
+    // scratch needs room for count / 2 objects
+    dyn_sorter_t sorter_storage;
+    const dyn_sorter_t *const sorter = &sorter_storage;
+    dyn_sorter_init(&sorter_storage, data_size, compare);
+
+    for (size_t first = 0; first < count; first += DYN_SORT_RUN_LENGTH) {
+        dyn_insertion_sort(sorter, SORT_AT(base, first),
+                           count - first < DYN_SORT_RUN_LENGTH ? count - first : DYN_SORT_RUN_LENGTH);
+    }
+    for (size_t width = DYN_SORT_RUN_LENGTH; width < count; width *= 2) {
+        for (size_t first = 0; first + width < count; first += 2 * width) {
+            const size_t pair = count - first - width > width ? 2 * width : count - first;
+            dyn_merge(sorter, SORT_AT(base, first), width, pair, scratch);
+        }
+    }
+}
+
+// Loads a key of the given width (1, 2, 4 or 8 bytes, native byte order) and maps it to an unsigned
+// value that sorts the same way: signed gets its sign bit flipped, floats get the usual
+// flip-everything-if-negative trick, descending flips it all again
+static uint64_t dyn_radix_key(const uint8_t *const object, const size_t key_width, const DYN_RADIX_FLAGS flags) {
+    uint64_t key;
+    switch (key_width) {
+        case 1: {
+            uint8_t temp;
+            memcpy(&temp, object, 1);
+            key = temp;
+            break;
+        }
+        case 2: {
+            uint16_t temp;
+            memcpy(&temp, object, 2);
+            key = temp;
+            break;
+        }
+        case 4: {
+            uint32_t temp;
+            memcpy(&temp, object, 4);
+            key = temp;
+            break;
+        }
+        default:
+            memcpy(&key, object, 8);
+    }
+    const uint64_t sign_bit = ((uint64_t) 1) << (key_width * 8 - 1);
+    if (flags & DYN_RADIX_FLOAT) {
+        // -0.0 lands right in front of 0.0, NaNs end up at the ends. Close enough.
+        key ^= (key & sign_bit) ? ~((uint64_t) 0) : sign_bit;
+    } else if (flags & DYN_RADIX_SIGNED) {
+        key ^= sign_bit;
+    }
+    if (flags & DYN_RADIX_DESCENDING) {
+        key = ~key;
+    }
+    // keep it to key_width bytes, the flips above can set bits past it
+    return key_width == 8 ? key : key & ((((uint64_t) 1) << (key_width * 8)) - 1);
+}
+
+bool dyn_radix_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size, const size_t key_offset,
+                           const size_t key_width, const DYN_RADIX_FLAGS flags, uint8_t *const scratch) {
+    // LSD radix sort, a byte at a time. Each pass is a stable scatter by one byte of the key,
+    // lowest byte first, so after the last pass it's sorted by the whole thing. Stable, no compares.
+    // All the histograms get counted in one read pass up front instead of one read per pass,
+    // and any byte that's the same for every object gets its pass skipped (small keys in wide fields
+    // are the common case, a 64 bit block id rarely needs more than 3 or 4 passes)
+    // scratch needs room for count objects
+    // Returns true if the sorted contents ended up in scratch instead of base
+    size_t histograms[8][256];
+    memset(histograms, 0x00, sizeof(size_t) * 256 * key_width);
+
+    const uint8_t *walker = base + key_offset;
+    for (size_t idx = 0; idx < count; ++idx, walker += data_size) {
+        const uint64_t key = dyn_radix_key(walker, key_width, flags);
+        for (size_t digit = 0; digit < key_width; ++digit) {
+            ++histograms[digit][(key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    dyn_sorter_t sorter;
+    dyn_sorter_init(&sorter, data_size, NULL);
+
+    uint8_t *source = base, *destination = scratch;
+    for (size_t digit = 0; digit < key_width; ++digit) {
+        size_t *const histogram = histograms[digit];
+        if (histogram[(dyn_radix_key(source + key_offset, key_width, flags) >> (digit * 8)) & 0xFF] == count) {
+            // everything has the same byte here, this pass wouldn't move anything
+            continue;
+        }
+        // counts to starting offsets
+        for (size_t bucket = 0, total = 0; bucket < 256; ++bucket) {
+            const size_t bucket_count = histogram[bucket];
+            histogram[bucket] = total;
+            total += bucket_count;
+        }
+        const uint8_t *object = source;
+        for (size_t idx = 0; idx < count; ++idx, object += data_size) {
+            const size_t bucket = (dyn_radix_key(object + key_offset, key_width, flags) >> (digit * 8)) & 0xFF;
+            sorter.move(destination + histogram[bucket]++ * data_size, object, data_size);
+        }
+        uint8_t *const temp = source;
+        source = destination;
+        destination = temp;
+    }
+    return source != base;
+}
+
+// One unit of parallel sort work: sort [base, base + count), or merge left and right into out
+typedef struct {
+    const dyn_sorter_t *sorter;
+    uint8_t *base;
+    size_t count;
+    const uint8_t *left;
+    size_t left_count;
+    const uint8_t *right;
+    size_t right_count;
+    uint8_t *out;
+} dyn_sort_task_t;
+
+static void *dyn_sort_task_sort(void *arg) {
+    const dyn_sort_task_t *const task = (const dyn_sort_task_t *) arg;
+    dyn_sort_buffer(task->base, task->count, task->sorter->size, task->sorter->compare);
+    return NULL;
+}
+
+static void *dyn_sort_task_merge(void *arg) {
+    // out of place merge, ties go left. Either side can be empty (which makes it a copy).
+    const dyn_sort_task_t *const task = (const dyn_sort_task_t *) arg;
+    const dyn_sorter_t *const sorter = task->sorter;
+    const size_t size = sorter->size;
+    const uint8_t *left = task->left, *const left_end = task->left + task->left_count * size;
+    const uint8_t *right = task->right, *const right_end = task->right + task->right_count * size;
+    uint8_t *out = task->out;
+    while (left < left_end && right < right_end) {
+        if (SORT_LESS(right, left)) {
+            sorter->move(out, right, size);
+            right += size;
+        } else {
+            sorter->move(out, left, size);
+            left += size;
+        }
+        out += size;
+    }
+    memcpy(out, left, left_end - left);
+    memcpy(out + (left_end - left), right, right_end - right);
+    return NULL;
+}
+
+// Finds how many of the first k merged objects come from left (the rest come from right)
+// Merge path partition, binary search along the diagonal. Ties go left, same as the merge.
+static size_t dyn_merge_split(const dyn_sorter_t *const sorter, const uint8_t *const left, const size_t left_count,
+                              const uint8_t *const right, const size_t right_count, const size_t k) {
+    size_t low = k > right_count ? k - right_count : 0, high = k < left_count ? k : left_count;
+    while (low < high) {
+        const size_t from_left = low + (high - low) / 2;
+        // right[k - from_left - 1] not less than left[from_left] means left[from_left] goes in first
+        if (!SORT_LESS(SORT_AT(right, k - from_left - 1), SORT_AT(left, from_left))) {
+            low = from_left + 1;
+        } else {
+            high = from_left;
+        }
+    }
+    return low;
+}
+
+bool dyn_parallel_sort_buffer(uint8_t *const base, const size_t count, const size_t data_size,
+                              int (*compare)(const void *, const void *), size_t nthreads, uint8_t *const scratch) {
+    // Parallel merge sort:
+    //  1. cut it into one chunk per thread, every thread pdqsorts its chunk
+    //  2. merge pairs of chunks, ping-ponging between base and scratch, until there's one chunk
+    // Every merge round keeps all the threads busy. Each pair of runs gets split into equal
+    // pieces of output (merge path) and each piece is an independent merge, so the last
+    // round (one big merge) isn't stuck on one core.
+    // scratch needs room for count objects
+    // Returns true if the sorted contents ended up in scratch instead of base
+    dyn_sorter_t sorter_storage;
+    const dyn_sorter_t *const sorter = &sorter_storage;
+    dyn_sorter_init(&sorter_storage, data_size, compare);
+
+    if (nthreads > DYN_PARALLEL_MAX_THREADS) {
+        nthreads = DYN_PARALLEL_MAX_THREADS;
+    }
+    if (nthreads > count / DYN_PARALLEL_SORT_MIN_CHUNK) {
+        nthreads = count / DYN_PARALLEL_SORT_MIN_CHUNK;
+    }
+    if (nthreads < 2) {
+        dyn_sort_buffer(base, count, data_size, compare);
+        return false;
+    }
+
+    dyn_sort_task_t tasks[2 * DYN_PARALLEL_MAX_THREADS];
+    size_t bounds[DYN_PARALLEL_MAX_THREADS + 1];
+    for (size_t idx = 0; idx <= nthreads; ++idx) {
+        bounds[idx] = count / nthreads * idx + (idx < count % nthreads ? idx : count % nthreads);
+    }
+    for (size_t idx = 0; idx < nthreads; ++idx) {
+        tasks[idx].sorter = sorter;
+        tasks[idx].base = SORT_AT(base, bounds[idx]);
+        tasks[idx].count = bounds[idx + 1] - bounds[idx];
+    }
+    dyn_run_tasks(tasks, sizeof(dyn_sort_task_t), nthreads, &dyn_sort_task_sort);
+
+    uint8_t *source = base, *destination = scratch;
+    for (size_t runs = nthreads; runs > 1; runs = (runs + 1) / 2) {
+        const size_t pairs = runs / 2, pieces = nthreads / pairs ? nthreads / pairs : 1;
+        size_t task_count = 0;
+        for (size_t pair = 0; pair < pairs; ++pair) {
+            const size_t first = bounds[2 * pair], middle = bounds[2 * pair + 1], last = bounds[2 * pair + 2];
+            const uint8_t *const left = SORT_AT(source, first), *const right = SORT_AT(source, middle);
+            const size_t left_count = middle - first, right_count = last - middle;
+            size_t split_left = 0, split_out = 0;
+            for (size_t piece = 1; piece <= pieces; ++piece) {
+                const size_t next_out = (last - first) / pieces * piece + (piece == pieces ? (last - first) % pieces : 0);
+                const size_t next_left = dyn_merge_split(sorter, left, left_count, right, right_count, next_out);
+                dyn_sort_task_t *const task = tasks + task_count++;
+                task->sorter = sorter;
+                task->left = SORT_AT(left, split_left);
+                task->left_count = next_left - split_left;
+                task->right = SORT_AT(right, split_out - split_left);
+                task->right_count = (next_out - next_left) - (split_out - split_left);
+                task->out = SORT_AT(destination, first + split_out);
+                split_left = next_left;
+                split_out = next_out;
+            }
+            bounds[pair + 1] = last;
+        }
+        if (runs & 0x01) {
+            // odd one out just gets copied over
+            dyn_sort_task_t *const task = tasks + task_count++;
+            task->sorter = sorter;
+            task->left = SORT_AT(source, bounds[runs - 1]);
+            task->left_count = bounds[runs] - bounds[runs - 1];
+            task->right = task->left; // empty, but memcpy still wants a real pointer
+            task->right_count = 0;
+            task->out = SORT_AT(destination, bounds[runs - 1]);
+            bounds[pairs + 1] = bounds[runs];
+        }
+        dyn_run_tasks(tasks, sizeof(dyn_sort_task_t), task_count, &dyn_sort_task_merge);
+        uint8_t *const temp = source;
+        source = destination;
+        destination = temp;
+    }
+    return source != base;
+}
+
+#undef SORT_AT
+#undef SORT_LESS
+#undef SORT_SWAP
+
+void *dyn_request_scratch(dyn_array_t *const dyn_array, const size_t bytes) {
+    if (bytes > dyn_array->scratch_size) {
+        // don't need the old contents, so no realloc
+        void *const scratch = dyn_alloc(&dyn_array->allocator, bytes);
+        if (!scratch) {
+            return NULL;
+        }
+        dyn_free(&dyn_array->allocator, dyn_array->scratch, dyn_array->scratch_size);
+        dyn_array->scratch = scratch;
+        dyn_array->scratch_size = bytes;
+    }
+    return dyn_array->scratch;
+}
+
+//
+///
+// SEGMENTED
+///
+//
+
+// Segment n holds DYN_MIN_CAPACITY << n objects, so the segments before it add up to DYN_MIN_CAPACITY * (2^n - 1)
+// Bias an index by DYN_MIN_CAPACITY and its top bit says which segment it's in, everything under that bit is
+// the slot in the segment. One count leading zeros and we're there.
+// index 0..15 -> 16..31 -> segment 0, index 16..47 -> 32..79 -> segment 1, and so on
+#define DYN_SEGMENT_SHIFT 4
+typedef char dyn_segment_shift_check[(1 << DYN_SEGMENT_SHIFT) == DYN_MIN_CAPACITY ? 1 : -1];
+
+// A slot for every segment size_t could possibly describe, way more than DYN_MAX_CAPACITY will ever use
+// (so the table is never reallocated either)
+#define DYN_SEGMENT_SLOTS (sizeof(size_t) << 3)
+
+// Objects in segment n, and in the first n segments
+#define DYN_SEGMENT_CAPACITY(n) (((size_t) DYN_MIN_CAPACITY) << (n))
+#define DYN_SEGMENTS_CAPACITY(n) (((size_t) DYN_MIN_CAPACITY) * ((((size_t) 1) << (n)) - 1))
+
+struct dyn_segmented {
+    size_t size;
+    size_t data_size;
+    size_t segment_count; // segments allocated, they're always the first segment_count slots
+    void (*destructor)(void *);
+    const dyn_kernels_t *kernels; // same tables as dyn_array
+    uint8_t *segments[DYN_SEGMENT_SLOTS];
+};
+
+// Position of the highest set bit (value can't be 0)
+static inline size_t dyn_log2(const size_t value) {
+#if defined(__GNUC__)
+    return (sizeof(unsigned long long) << 3) - 1 - (size_t) __builtin_clzll((unsigned long long) value);
+#else
+    size_t bit = 0;
+    while (value >> bit >> 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Segment holding the object at index
+#define DYN_SEGMENT_OF(index) (dyn_log2((index) + DYN_MIN_CAPACITY) - DYN_SEGMENT_SHIFT)
+
+// Where the object at index lives (index must be under capacity)
+static inline uint8_t *dyn_segmented_slot(const dyn_segmented_t *const segmented, const size_t index) {
+    const size_t biased = index + DYN_MIN_CAPACITY;
+    const size_t top = dyn_log2(biased);
+    return segmented->segments[top - DYN_SEGMENT_SHIFT] + (biased - (((size_t) 1) << top)) * segmented->data_size;
+}
+
+dyn_segmented_t *dyn_segmented_create(const size_t data_type_size, void (*destruct_func)(void *)) {
+    if (data_type_size) {
+        dyn_segmented_t *segmented = (dyn_segmented_t *) malloc(sizeof(dyn_segmented_t));
+        if (segmented) {
+            segmented->size = 0;
+            segmented->data_size = data_type_size;
+            segmented->segment_count = 0;
+            segmented->destructor = destruct_func;
+            segmented->kernels = dyn_select_kernels(data_type_size);
+            // first segment up front, same as dyn_array_create
+            if (dyn_segmented_grow(segmented, 1)) {
+                return segmented;
+            }
+            free(segmented);
+        }
+    }
+    return NULL;
+}
+
+void dyn_segmented_destroy(dyn_segmented_t *const segmented) {
+    if (segmented) {
+        dyn_segmented_clear(segmented);
+        for (size_t segment = 0; segment < segmented->segment_count; ++segment) {
+            free(segmented->segments[segment]);
+        }
+        free(segmented);
+    }
+}
+
+void *dyn_segmented_at(const dyn_segmented_t *const segmented, const size_t index) {
+    if (segmented && index < segmented->size) {
+        return dyn_segmented_slot(segmented, index);
+    }
+    return NULL;
+}
+
+void *dyn_segmented_front(const dyn_segmented_t *const segmented) {
+    return dyn_segmented_at(segmented, 0);
+}
+
+void *dyn_segmented_back(const dyn_segmented_t *const segmented) {
+    return segmented && segmented->size ? dyn_segmented_slot(segmented, segmented->size - 1) : NULL;
+}
+
+bool dyn_segmented_push_back(dyn_segmented_t *const segmented, const void *const object) {
+    if (segmented && object && segmented->size < DYN_MAX_CAPACITY
+            && dyn_segmented_grow(segmented, segmented->size + 1)) {
+        segmented->kernels->move(dyn_segmented_slot(segmented, segmented->size), (const uint8_t *) object,
+                                 segmented->data_size);
+        ++segmented->size;
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_push_back_n(dyn_segmented_t *const segmented, const void *const objects, const size_t count) {
+    if (segmented && objects && count && count <= DYN_MAX_CAPACITY - segmented->size
+            && dyn_segmented_grow(segmented, segmented->size + count)) {
+        // one copy per segment touched, a segment ends right before the biased index hits the next power of two
+        const uint8_t *source = (const uint8_t *) objects;
+        size_t index = segmented->size;
+        for (size_t left = count; left;) {
+            const size_t room = (((size_t) 2) << dyn_log2(index + DYN_MIN_CAPACITY)) - (index + DYN_MIN_CAPACITY);
+            const size_t batch = left < room ? left : room;
+            segmented->kernels->copy(dyn_segmented_slot(segmented, index), source, batch, segmented->data_size);
+            source += batch * segmented->data_size;
+            index += batch;
+            left -= batch;
+        }
+        segmented->size = index;
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_pop_back(dyn_segmented_t *const segmented) {
+    if (segmented && segmented->size) {
+        --segmented->size;
+        if (segmented->destructor) {
+            segmented->destructor(dyn_segmented_slot(segmented, segmented->size));
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_extract_back(dyn_segmented_t *const segmented, void *const object) {
+    if (segmented && segmented->size && object) {
+        --segmented->size;
+        segmented->kernels->move((uint8_t *) object, dyn_segmented_slot(segmented, segmented->size),
+                                 segmented->data_size);
+        return true;
+    }
+    return false;
+}
+
+void dyn_segmented_clear(dyn_segmented_t *const segmented) {
+    if (segmented && segmented->size) {
+        if (segmented->destructor) {
+            dyn_segmented_for_each_span(segmented, &dyn_segmented_destruct_span, segmented, 0);
+        }
+        segmented->size = 0;
+    }
+}
+
+bool dyn_segmented_empty(const dyn_segmented_t *const segmented) {
+    return dyn_segmented_size(segmented) == 0;
+}
+
+size_t dyn_segmented_size(const dyn_segmented_t *const segmented) {
+    return segmented ? segmented->size : 0;
+}
+
+size_t dyn_segmented_capacity(const dyn_segmented_t *const segmented) {
+    return segmented ? DYN_SEGMENTS_CAPACITY(segmented->segment_count) : 0;
+}
+
+size_t dyn_segmented_data_size(const dyn_segmented_t *const segmented) {
+    return segmented ? segmented->data_size : 0;
+}
+
+bool dyn_segmented_reserve(dyn_segmented_t *const segmented, const size_t capacity) {
+    return segmented && capacity <= DYN_MAX_CAPACITY && dyn_segmented_grow(segmented, capacity);
+}
+
+bool dyn_segmented_shrink_to_fit(dyn_segmented_t *const segmented) {
+    if (segmented) {
+        // keeps the first segment around even when empty, same as dyn_array keeping room for one
+        const size_t needed = segmented->size ? DYN_SEGMENT_OF(segmented->size - 1) + 1 : 1;
+        while (segmented->segment_count > needed) {
+            free(segmented->segments[--segmented->segment_count]);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_for_each(dyn_segmented_t *const segmented, void (*func)(void *const, void *), void *arg) {
+    if (segmented && func) {
+        // whole segments until the last (partly filled) one, the kernels keep the stride a constant
+        size_t left = segmented->size;
+        for (size_t segment = 0; left; ++segment) {
+            const size_t count = left < DYN_SEGMENT_CAPACITY(segment) ? left : DYN_SEGMENT_CAPACITY(segment);
+            segmented->kernels->walk(segmented->segments[segment], count, segmented->data_size, func, arg);
+            left -= count;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_for_each_span(dyn_segmented_t *const segmented, void (*func)(void *const, const size_t, void *),
+                                 void *arg, const size_t max_span) {
+    if (segmented && func) {
+        const size_t span = max_span ? max_span : SIZE_MAX;
+        size_t left = segmented->size;
+        for (size_t segment = 0; left; ++segment) {
+            const size_t run = left < DYN_SEGMENT_CAPACITY(segment) ? left : DYN_SEGMENT_CAPACITY(segment);
+            for (size_t offset = 0; offset < run; offset += span) {
+                const size_t count = run - offset < span ? run - offset : span;
+                func((void *const) (segmented->segments[segment] + offset * segmented->data_size), count, arg);
+            }
+            left -= run;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dyn_segmented_grow(dyn_segmented_t *const segmented, const size_t capacity) {
+    // new segments only, nothing already allocated ever moves
+    // (capacity is at most DYN_MAX_CAPACITY, so we run out of memory long before we run out of slots)
+    while (DYN_SEGMENTS_CAPACITY(segmented->segment_count) < capacity) {
+        const size_t objects = DYN_SEGMENT_CAPACITY(segmented->segment_count);
+        if (objects > SIZE_MAX / segmented->data_size) {
+            return false;
+        }
+        uint8_t *const segment = (uint8_t *) malloc(objects * segmented->data_size);
+        if (!segment) {
+            return false;
+        }
+        segmented->segments[segmented->segment_count++] = segment;
+    }
+    return true;
+}
+
+void dyn_segmented_destruct_span(void *const first, const size_t count, void *segmented_ptr) {
+    const dyn_segmented_t *const segmented = (const dyn_segmented_t *) segmented_ptr;
+    for (size_t idx = 0; idx < count; ++idx) {
+        segmented->destructor(((uint8_t *) first) + idx * segmented->data_size);
     }
-    return false;
 }
 
 //
@@ -0,0 +1,304 @@
+#include "../include/dyn_array.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+/*
+    template <typename T> class dyn_array;
+
+    1. Default/capacity/initializer_list construction, size/capacity/empty
+    2. push_back/emplace_back/insert/emplace/erase/pop_back, front/back/[]/at (at throws out of range)
+    3. Iterators work with <algorithm> (sort, find, accumulate, reverse iterators)
+    4. Copy construction/assignment copy, move construction/assignment steal the handle
+    5. Non-trivial T: destructors run exactly once (erase, pop_back, clear, destroy), move-only T works
+    6. Escape hatch: handle() works with the C API, release() hands it off, adopting checks the size,
+       non-const access makes the C side forget it was sorted
+    7. Moved-from arrays are empty and usable again
+    8. Inserting an element of the array into itself survives the reallocation
+    9. T's copy constructor throwing partway through a copy/initializer_list construction leaks nothing
+    10. insert/emplace past end() throws out_of_range, array untouched
+*/
+
+int int_compare(const void *a, const void *b) {
+    return (*static_cast<const int *>(a) > *static_cast<const int *>(b)) -
+           (*static_cast<const int *>(a) < *static_cast<const int *>(b));
+}
+
+// counts live instances, so leaks and double destructs both show up
+struct tracked {
+    static int live;
+    int value;
+
+    explicit tracked(const int v) : value(v) { ++live; }
+    tracked(const tracked &other) : value(other.value) { ++live; }
+    ~tracked() { --live; }
+};
+int tracked::live = 0;
+
+// tracked, but the copy constructor throws once copies_left runs out
+struct throws_on_copy {
+    static int live;
+    static int copies_left;
+    int value;
+
+    explicit throws_on_copy(const int v) : value(v) { ++live; }
+    throws_on_copy(const throws_on_copy &other) : value(other.value) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("throws_on_copy");
+        }
+        ++live;
+    }
+    ~throws_on_copy() { --live; }
+};
+int throws_on_copy::live = 0;
+int throws_on_copy::copies_left = 1000;
+
+void dyn_array_basic_tests();
+
+void dyn_array_ownership_tests();
+
+void dyn_array_nontrivial_tests();
+
+int main() {
+    dyn_array_basic_tests();
+
+    dyn_array_ownership_tests();
+
+    dyn_array_nontrivial_tests();
+
+    puts("TESTS PASSED");
+}
+
+void dyn_array_basic_tests() {
+    // 1
+    osf::dyn_array<int> numbers;
+    assert(numbers.empty());
+    assert(numbers.size() == 0);
+    assert(numbers.capacity() >= 16);
+    assert(numbers.begin() == numbers.end());
+
+    osf::dyn_array<int> big(100);
+    assert(big.capacity() >= 100);
+
+    osf::dyn_array<int> listed = {5, 3, 9, 1};
+    assert(listed.size() == 4);
+    assert(listed[0] == 5 && listed[3] == 1);
+
+    // 2
+    for (int i = 0; i < 40; ++i) {
+        numbers.push_back(i);
+    }
+    assert(numbers.size() == 40);
+    assert(numbers.front() == 0 && numbers.back() == 39);
+    assert(numbers.at(20) == 20);
+    bool threw = false;
+    try {
+        numbers.at(40);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw);
+
+    assert(numbers.emplace_back(100) == 100);
+    numbers.pop_back();
+    assert(*numbers.insert(numbers.begin(), -1) == -1);
+    assert(*numbers.emplace(numbers.begin() + 10, -2) == -2);
+    assert(numbers.size() == 42);
+    assert(numbers[0] == -1 && numbers[10] == -2 && numbers[11] == 9);
+    assert(*numbers.erase(numbers.begin() + 10) == 9);
+    assert(*numbers.erase(numbers.begin()) == 0);
+    assert(numbers.erase(numbers.begin() + 30, numbers.end()) == numbers.end());
+    assert(numbers.size() == 30);
+    assert(numbers.erase(numbers.begin(), numbers.begin()) == numbers.begin());
+
+    // 3
+    std::reverse(numbers.begin(), numbers.end());
+    assert(numbers.front() == 29);
+    std::sort(numbers.begin(), numbers.end());
+    assert(std::is_sorted(numbers.begin(), numbers.end()));
+    assert(std::find(numbers.begin(), numbers.end(), 17) - numbers.begin() == 17);
+    assert(std::accumulate(numbers.cbegin(), numbers.cend(), 0) == 29 * 30 / 2);
+    assert(*numbers.rbegin() == 29);
+    assert(std::distance(numbers.rbegin(), numbers.rend()) == 30);
+    int expected = 0;
+    for (const int number : numbers) {
+        assert(number == expected++);
+    }
+
+    numbers.clear();
+    assert(numbers.empty());
+    numbers.shrink_to_fit();
+    numbers.reserve(64);
+    assert(numbers.capacity() >= 64);
+}
+
+void dyn_array_ownership_tests() {
+    // 4
+    osf::dyn_array<int> original = {1, 2, 3};
+    osf::dyn_array<int> copy(original);
+    copy[0] = 10;
+    assert(original[0] == 1);
+    assert(copy.size() == 3 && copy[2] == 3);
+
+    copy = original;
+    assert(copy[0] == 1);
+    assert(copy.handle() != original.handle());
+
+    const dyn_array_t *const handle = original.handle();
+    osf::dyn_array<int> moved(std::move(original));
+    assert(moved.handle() == handle);
+    assert(original.handle() == nullptr);
+    assert(moved.size() == 3);
+
+    copy = std::move(moved);
+    assert(copy.handle() == handle);
+    assert(moved.handle() == nullptr);
+
+    // 7
+    assert(original.empty() && original.size() == 0 && original.begin() == original.end());
+    original.push_back(7);
+    assert(original.size() == 1 && original[0] == 7);
+    moved.reserve(10);
+    assert(moved.capacity() >= 10);
+
+    // 6
+    assert(dyn_array_push_back(copy.handle(), &copy[0]));
+    assert(copy.size() == 4 && copy.back() == 1);
+    dyn_array_t *const released = copy.release();
+    assert(released == handle);
+    assert(copy.handle() == nullptr);
+    osf::dyn_array<int> adopted(released);
+    assert(adopted.size() == 4);
+
+    dyn_array_t *const wrong_size = dyn_array_create(0, sizeof(double), NULL);
+    bool threw = false;
+    try {
+        osf::dyn_array<int> bad(wrong_size);
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+    dyn_array_destroy(wrong_size);
+
+    // a ring through the handle, data() straightens it out
+    assert(dyn_array_set_ring_mode(adopted.handle(), true));
+    const int front = 0;
+    assert(dyn_array_push_front(adopted.handle(), &front));
+    assert(adopted.data()[0] == 0 && adopted.data()[1] == 1);
+    assert(std::is_sorted(adopted.begin(), adopted.begin() + 4));
+
+    // sorted through the C API, then rearranged from C++, the C side can't keep trusting its flag
+    osf::dyn_array<int> ordered = {5, 3, 9, 1, 7};
+    assert(dyn_array_sort(ordered.handle(), &int_compare));
+    const osf::dyn_array<int> &viewed = ordered;
+    assert(viewed[0] == 1 && *viewed.begin() == 1);
+    assert(dyn_array_is_sorted(ordered.handle(), &int_compare));
+    std::reverse(ordered.begin(), ordered.end());
+    const int seven = 7;
+    assert(dyn_array_find(ordered.handle(), &seven, &int_compare) == 1);
+    assert(dyn_array_sort(ordered.handle(), &int_compare));
+    ordered[0] = 8;
+    assert(dyn_array_contains(ordered.handle(), &seven, &int_compare));
+    assert(dyn_array_nth_element(ordered.handle(), 0, &int_compare));
+    assert(ordered.front() == 3);
+}
+
+void dyn_array_nontrivial_tests() {
+    // 5
+    {
+        osf::dyn_array<tracked> objects;
+        for (int i = 0; i < 20; ++i) {
+            objects.emplace_back(i);
+        }
+        assert(tracked::live == 20);
+        objects.pop_back();
+        assert(tracked::live == 19);
+        objects.erase(objects.begin() + 5);
+        assert(tracked::live == 18);
+        assert(objects[5].value == 6);
+        objects.insert(objects.begin(), tracked(-1));
+        assert(tracked::live == 19);
+        assert(objects.front().value == -1);
+
+        // 8
+        for (int i = 0; i < 40; ++i) {
+            objects.push_back(objects[0]);
+        }
+        assert(objects.back().value == -1);
+        assert(tracked::live == 59);
+
+        osf::dyn_array<tracked> copy(objects);
+        assert(tracked::live == 118);
+        copy.clear();
+        assert(tracked::live == 59);
+        copy = std::move(objects);
+        assert(tracked::live == 59);
+    }
+    assert(tracked::live == 0);
+
+    osf::dyn_array<std::unique_ptr<int>> pointers;
+    for (int i = 0; i < 20; ++i) {
+        pointers.push_back(std::unique_ptr<int>(new int(i)));
+    }
+    pointers.erase(pointers.begin());
+    std::sort(pointers.begin(), pointers.end(),
+              [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) { return *a > *b; });
+    assert(*pointers.front() == 19 && *pointers.back() == 1);
+    osf::dyn_array<std::unique_ptr<int>> stolen(std::move(pointers));
+    assert(stolen.size() == 19);
+
+    // 9
+    {
+        const std::initializer_list<throws_on_copy> init = {throws_on_copy(1), throws_on_copy(2), throws_on_copy(3),
+                                                            throws_on_copy(4), throws_on_copy(5)};
+        const int before = throws_on_copy::live;
+        throws_on_copy::copies_left = 2;
+        bool threw = false;
+        try {
+            osf::dyn_array<throws_on_copy> partial(init);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+        assert(throws_on_copy::live == before);
+
+        throws_on_copy::copies_left = 1000;
+        osf::dyn_array<throws_on_copy> source(init);
+        assert(throws_on_copy::live == before + 5);
+        throws_on_copy::copies_left = 2;
+        threw = false;
+        try {
+            osf::dyn_array<throws_on_copy> copy(source);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+        assert(throws_on_copy::live == before + 5);
+        throws_on_copy::copies_left = 1000;
+    }
+
+    // 10
+    osf::dyn_array<int> numbers = {1, 2, 3};
+    bool threw = false;
+    try {
+        numbers.insert(numbers.begin() + 4, 9);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        numbers.emplace(numbers.end() + 1, 9);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw);
+    assert(numbers.size() == 3 && numbers[2] == 3);
+    assert(*numbers.insert(numbers.end(), 4) == 4);
+    assert(numbers.size() == 4);
+}
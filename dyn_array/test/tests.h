@@ -1,9 +1,17 @@
+// before any system header, so dyn_array.c gets mremap
+#define _GNU_SOURCE
 #define DYN_MAX_CAPACITY 64
+// so the (capped) test arrays are big enough to actually go parallel
+#define DYN_PARALLEL_SORT_MIN_CHUNK 4
+// and big enough to get mapped
+#define DYN_MMAP_THRESHOLD 4096
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "../src/dyn_array.c"
+#include "../include/dyn_array_typed.h"
 
 /*
     dyn_array_t *dyn_array_create(size_t capacity, size_t data_type_size, void (*destruct_func)(void *));
@@ -186,6 +194,297 @@
         3. NORMAL, null arg
         4. FAIL, null array
         5. FAIL, null func
+
+    size_t dyn_array_lower_bound(const dyn_array_t *const dyn_array, const void *const object,
+                                 int (*compare)(const void *, const void *));
+    size_t dyn_array_upper_bound(const dyn_array_t *const dyn_array, const void *const object,
+                                 int (*compare)(const void *, const void *));
+        1. NORMAL, before everything, after everything, between, on a run of equals
+        2. NORMAL, empty
+        3. FAIL, null array
+        4. FAIL, null object
+        5. FAIL, null comparator
+
+    bool dyn_array_equal_range(const dyn_array_t *const dyn_array, const void *const object,
+                               int (*compare)(const void *, const void *), size_t *first, size_t *last);
+        1. NORMAL, match (short and long runs)
+        2. NORMAL, no match
+        3. FAIL, null first/last
+        4. FAIL, null array
+
+    void *dyn_array_bsearch(const dyn_array_t *const dyn_array, const void *const object,
+                            int (*compare)(const void *, const void *));
+        1. NORMAL, found (first of equals)
+        2. NORMAL, not found
+        3. FAIL, null array
+
+    bool dyn_array_insert_sorted_stable(dyn_array_t *const dyn_array, const void *const object,
+                                        int (*compare)(const void *, const void *));
+        1. NORMAL, equal objects keep insertion order
+        2. FAIL, NULL array
+        3. FAIL, null object
+        4. FAIL, null comparator
+
+    bool dyn_array_push_front_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+    bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+    bool dyn_array_insert_n(dyn_array_t *const dyn_array, const size_t index, const void *const objects, const size_t count);
+        1. NORMAL, front/back/middle, order kept
+        2. NORMAL, past capacity boundary (grows once)
+        3. FAIL, count = 0
+        4. FAIL, null objects
+        5. FAIL, null array
+        6. FAIL, past max capacity, huge count
+        7. FAIL, insert index > size
+
+    bool dyn_array_pop_front_n(dyn_array_t *const dyn_array, const size_t count);
+    bool dyn_array_pop_back_n(dyn_array_t *const dyn_array, const size_t count);
+    bool dyn_array_erase_n(dyn_array_t *const dyn_array, const size_t index, const size_t count);
+        1. NORMAL, front/back/middle
+        2. NORMAL, with destructor, destructs exactly count
+        3. FAIL, count > size, huge count
+        4. FAIL, count = 0
+        5. FAIL, null array
+
+    bool dyn_array_extract_n(dyn_array_t *const dyn_array, const size_t index, void *const objects, const size_t count);
+        1. NORMAL, with destructor, assert not destructed
+        2. FAIL, out of range, huge count
+        3. FAIL, null objects
+        4. FAIL, null array
+
+    bool dyn_array_append(dyn_array_t *const dst, const dyn_array_t *const src);
+    bool dyn_array_append_range(dyn_array_t *const dst, const dyn_array_t *const src, const size_t first, const size_t count);
+        1. NORMAL, append
+        2. NORMAL, append empty
+        3. NORMAL, append to self
+        4. NORMAL, range
+        5. FAIL, range out of bounds
+        6. FAIL, data size mismatch
+        7. FAIL, null arrays
+
+    bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity);
+        1. NORMAL, grow to exact capacity, contents kept
+        2. NORMAL, request below capacity (no change)
+        3. FAIL, past max capacity
+        4. FAIL, null array
+
+    bool dyn_array_shrink_to_fit(dyn_array_t *const dyn_array);
+        1. NORMAL, contents, capacity == size
+        2. NORMAL, empty, capacity == 1
+        3. NORMAL, growth after shrink is back on the normal steps
+        4. FAIL, null array
+
+    bool dyn_array_set_growth(dyn_array_t *const dyn_array, const DYN_GROWTH_POLICY policy, const size_t max_step);
+        1. NORMAL, half
+        2. NORMAL, exact
+        3. NORMAL, max step
+        4. NORMAL, grow up to max capacity
+        5. FAIL, bad policy
+        6. FAIL, null array
+
+    bool dyn_array_set_ring_mode(dyn_array_t *const dyn_array, const bool enable);
+        1. NORMAL, push_front doesn't move anything, wraps around the end
+        2. NORMAL, FIFO (push_back/pop_front) running past capacity many times without growing
+        3. NORMAL, at/front/back/for_each across the wrap
+        4. NORMAL, growth while wrapped keeps order
+        5. NORMAL, export/sort/insert in the middle straighten it out
+        6. NORMAL, bulk front/back operations across the wrap, destructor counts
+        7. NORMAL, turning it off straightens it out
+        8. FAIL, null array
+        (and the in-place rotation fallback, since we can't make malloc fail on demand)
+
+    size_t dyn_array_prune(dyn_array_t *const dyn_array, bool (*predicate)(const void *const, void *), void *arg);
+        1. NORMAL, scattered removals, order kept
+        2. NORMAL, with destructor, only removed objects destructed
+        3. NORMAL, nothing removed
+        4. NORMAL, everything removed
+        5. NORMAL, empty
+        6. NORMAL, wrapped ring
+        7. FAIL, null array
+        8. FAIL, null predicate
+
+    bool dyn_array_sort_stable(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *));
+        1. NORMAL, contents, equal objects keep their order
+        2. NORMAL, sort with 1 object
+        3. NORMAL, wrapped ring
+        4. NORMAL, scratch buffer is reused, shrink_to_fit frees it
+        5. FAIL, no array
+        6. FAIL, empty array
+        7. FAIL, null comparator
+
+    bool dyn_array_sort_parallel(dyn_array_t *const dyn_array, int (*compare)(const void *, const void *),
+                                 const size_t nthreads);
+        1. NORMAL, contents, odd and even thread counts, more threads than chunks
+        2. NORMAL, 0 and 1 threads (serial)
+        3. NORMAL, wrapped ring
+        4. NORMAL, sort with 1 object
+        5. FAIL, no array
+        6. FAIL, empty array
+        7. FAIL, null comparator
+        (and the engine directly, against qsort, with every kernel size)
+
+    bool dyn_array_for_each_span(dyn_array_t *const dyn_array, void (*func)(void *const, const size_t, void *), void *arg,
+                                 const size_t max_span);
+        1. NORMAL, one span, every object in order
+        2. NORMAL, max_span splits it up, last span is the leftovers
+        3. NORMAL, wrapped ring is two spans, nothing moves
+        4. NORMAL, empty
+        5. FAIL, null array
+        6. FAIL, null function
+
+    bool dyn_array_for_each_parallel(dyn_array_t *const dyn_array, void (*func)(void *const, void *), void *arg,
+                                     const size_t nthreads, const size_t grain);
+        1. NORMAL, every object visited once, chunks start on cache lines
+        2. NORMAL, more threads than the grain allows, default grain
+        3. NORMAL, wrapped ring
+        4. NORMAL, empty
+        5. FAIL, null array
+        6. FAIL, null function
+
+    bool dyn_array_reduce_parallel(dyn_array_t *const dyn_array, void (*accumulate)(void *const, const void *const, void *),
+                                   void (*combine)(void *const, const void *const, void *), void *const result,
+                                   const void *const identity, const size_t accumulator_size, void *arg,
+                                   const size_t nthreads, const size_t grain);
+        1. NORMAL, sum
+        2. NORMAL, combine happens in order (non-commutative combine)
+        3. NORMAL, empty (result untouched)
+        4. FAIL, null array, accumulate, combine, result, identity, zero size
+
+    bool dyn_array_sort_radix(dyn_array_t *const dyn_array, const size_t key_offset, const size_t key_width,
+                              const DYN_RADIX_FLAGS flags);
+        1. NORMAL, unsigned/signed/float/double keys, every width, ascending and descending, stable
+        2. NORMAL, key at an offset, odd number of passes (result comes back from scratch)
+        3. NORMAL, wrapped ring
+        4. NORMAL, sort with 1 object
+        5. FAIL, no array
+        6. FAIL, empty array
+        7. FAIL, bad width, key past the end of the object, float that isn't 4 or 8, unknown flag
+
+    DYN_ARRAY_DEFINE(name, T);
+        1. NORMAL, init/destroy, push_back past the starting capacity (grows)
+        2. NORMAL, at/front/back, out of range is NULL
+        3. NORMAL, insert/erase/extract at the front, middle and end
+        4. NORMAL, push/pop/extract front and back
+        5. NORMAL, reserve, clear, empty, size
+        6. NORMAL, export to and import from a generic dyn_array_t
+        7. FAIL, import from a dyn_array_t holding something else
+        8. FAIL, null array everywhere, bad indices, null object pointers
+
+    dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+                                                 void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+        1. NORMAL, counting allocator, every byte that goes out comes back (growth, sort scratch, shrink, destroy)
+        2. NORMAL, bump arena, no realloc or free (grows by copying, nothing given back)
+        3. NORMAL, NULL allocator is plain malloc
+        4. FAIL, allocator out of memory (create, growth, sort scratch), array still good after
+        5. FAIL, no alloc callback, data_size == 0, capacity > DYN_MAX_CAPACITY
+
+    dyn_array_t *dyn_array_init_inline(void *const buffer, const size_t buffer_size, const size_t data_type_size,
+                                       void (*destruct_func)(void *));
+        1. NORMAL, fills the buffer without touching the heap
+        2. NORMAL, spills to the heap past the buffer, plain and wrapped ring
+        3. NORMAL, shrink_to_fit moves back into the buffer, grows back out again
+        4. NORMAL, sort (scratch) and reserve
+        5. NORMAL, destroy runs destructors, frees the spill, leaves the buffer alone
+        6. FAIL, null buffer, buffer too small for one object, misaligned buffer, data_size == 0
+
+    dyn_segmented_t *dyn_segmented_create(const size_t data_type_size, void (*destruct_func)(void *));
+        1. NORMAL, push_back across segment boundaries, at/front/back, pointers never move
+        2. NORMAL, push_back_n across several segments at once
+        3. NORMAL, for_each and for_each_span (one span per segment, max_span splits them)
+        4. NORMAL, pop/extract_back, clear and destroy run destructors (extract doesn't)
+        5. NORMAL, reserve adds segments, shrink_to_fit frees them
+        6. NORMAL, index math for huge indices
+        7. FAIL, data_size == 0, past DYN_MAX_CAPACITY, out of range, null everything
+
+    bool dyn_array_save(const dyn_array_t *const dyn_array, const char *const path);
+    dyn_array_t *dyn_array_map(const char *const path, const DYN_MAP_FLAGS flags);
+        1. NORMAL, save and map read-only, same contents, everything that changes it fails
+        2. NORMAL, map private, edits stick in the array but not the file, growing copies out
+        3. NORMAL, save a wrapped ring, comes back in order
+        4. NORMAL, save an empty array, maps as an empty (unmapped) array, still read-only unless private
+        5. FAIL, missing file, cut short, bad magic/version/data_size, unknown flag
+        6. FAIL, null array/path, unwritable path
+
+    bool dyn_array_heapify(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+    bool dyn_array_heap_push(dyn_array_t *const dyn_array, const void *const object,
+                             int (*compare)(const void *const, const void *const));
+    bool dyn_array_heap_pop(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+    bool dyn_array_heap_extract(dyn_array_t *const dyn_array, void *const object,
+                                int (*compare)(const void *const, const void *const));
+    void *dyn_array_heap_top(const dyn_array_t *const dyn_array);
+    bool dyn_array_heap_update(dyn_array_t *const dyn_array, const size_t index,
+                               int (*compare)(const void *const, const void *const));
+    bool dyn_array_set_heap_arity(dyn_array_t *const dyn_array, const size_t arity);
+        1. NORMAL, push keeps it a heap, extract comes out in order, arity 2, 3 and 4
+        2. NORMAL, heapify a shuffled array, with duplicates
+        3. NORMAL, update after raising and lowering priorities
+        4. NORMAL, pop runs the destructor, extract doesn't
+        5. NORMAL, wrapped ring, min-heap with a flipped comparator
+        6. FAIL, empty, null array/object/compare, bad index, bad arity, read-only
+
+    bool dyn_array_is_sorted(const dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+    size_t dyn_array_find(const dyn_array_t *const dyn_array, const void *const object,
+                          int (*compare)(const void *const, const void *const));
+    bool dyn_array_contains(const dyn_array_t *const dyn_array, const void *const object,
+                            int (*compare)(const void *const, const void *const));
+    SORTED flag (internal)
+        1. NORMAL, sort sets it (every sort but radix), pops/erase/prune/clear keep it
+        2. NORMAL, in order inserts/pushes/appends keep it, out of order ones drop it, so does a different comparator
+        3. NORMAL, find/contains agree flagged and unflagged, first of duplicates, wrapped ring
+        4. NORMAL, is_sorted scans and then remembers, sorting again fixes in place edits
+        5. NORMAL, heap functions and radix sort drop it
+        6. FAIL, null array/object/compare, not found
+        7. NORMAL, for_each/for_each_span/for_each_parallel drop it, find/nth_element/top_k right after negating everything
+
+    size_t dyn_array_unique(dyn_array_t *const dyn_array, int (*compare)(const void *const, const void *const));
+    bool dyn_array_merge(dyn_array_t *const dst, const dyn_array_t *const a, const dyn_array_t *const b,
+                         int (*compare)(const void *const, const void *const));
+    bool dyn_array_set_union(...), dyn_array_set_intersection(...), dyn_array_set_difference(...);
+        1. NORMAL, unique drops runs of duplicates, flagged (gallop) and unflagged agree, destructor runs on the dropped
+        2. NORMAL, unique on a wrapped ring, all equal, no duplicates, empty
+        3. NORMAL, merge is stable (a's equal objects first), appends to what dst already has
+        4. NORMAL, union/intersection/difference keep multiset counts, checked against a brute force count
+        5. NORMAL, reserved dst doesn't reallocate, wrapped ring sources, a == b, SORTED flag carries over
+        6. FAIL, null anything, dst is a or b, mismatched data_size, read-only dst, too big
+
+    bool dyn_array_erase_unordered(dyn_array_t *const dyn_array, const size_t index);
+    bool dyn_array_extract_unordered(dyn_array_t *const dyn_array, const size_t index, void *const object);
+        1. NORMAL, front/middle/back, the back object fills the hole
+        2. NORMAL, erase runs the destructor once, extract doesn't
+        3. NORMAL, wrapped ring, down to empty
+        4. NORMAL, SORTED flag dropped unless it was the back
+        5. FAIL, out of range, empty, null array/object, read-only
+
+    bool dyn_array_nth_element(dyn_array_t *const dyn_array, const size_t nth, int (*compare)(const void *, const void *));
+    bool dyn_array_partial_sort(dyn_array_t *const dyn_array, const size_t k, int (*compare)(const void *, const void *));
+    size_t dyn_array_top_k(const dyn_array_t *const dyn_array, const size_t k, void *const objects,
+                           int (*compare)(const void *, const void *));
+        1. NORMAL, nth element is what a sort puts there, nothing bigger before it or smaller after it
+        2. NORMAL, partial sort puts the k smallest up front in order, k = 0 and k >= size
+        3. NORMAL, top k matches the back of a sorted copy reversed, array untouched, k > size
+        4. NORMAL, wrapped ring, SORTED flag (fast paths, dropped by nth/partial, kept by top k)
+        5. FAIL, nth out of range, null array/objects/compare, read-only
+
+    Selection engine (internal, same deal as the sort engine)
+        1. Introselect against qsort for every pattern and a few object sizes, first/middle/last/random nth
+        2. Heap sort fallback with no bad partitions allowed
+        3. Top k heap fed in two runs against qsort, k = 1, some, all
+
+    Default allocator (internal, mmap/mremap past DYN_MMAP_THRESHOLD on Linux)
+        1. NORMAL, small blocks malloc'd, big ones mapped (page aligned)
+        2. NORMAL, mapped block grows and shrinks with mremap, contents survive
+        3. NORMAL, crossing the threshold either way, contents survive
+        4. NORMAL, array growing past the threshold, plain and wrapped ring, shrink_to_fit back under it
+
+    Size specialized kernels (internal, picked by dyn_array_create)
+        1. Each common size (1, 2, 4, 8, 16, 32) gets its own table, everything else gets the generic one
+        2. copy/swap/walk agree with plain memcpy for every table, one object and many
+        3. push/insert/extract/for_each round trip through the array for every size, plain and ring
+
+    Sort engine (the array tests are capped at DYN_MAX_CAPACITY, so the engine gets hit directly)
+        1. Every kernel size (4, 8, 16, 32, generic) against qsort, big enough for ninther pivots
+        2. Sorted, reversed, all equal, few unique, organ pipe and sawtooth inputs
+        3. Heap sort fallback
+        4. Stable sort keeps equal objects in order, every kernel size
 */
 
 // Shamelessly stolen from
@@ -228,6 +527,73 @@ int block_compare_inv(const void *const a, const void *const b) {
     return ((int)(((const uint8_t *)b)[0])) - (((const uint8_t *)a)[0]);
 }
 
+int int_compare(const void *const a, const void *const b) {
+    const int x = *((const int *)a), y = *((const int *)b);
+    return (x > y) - (x < y);
+}
+
+// Keeps a running total of what's out, and fails on demand
+typedef struct {
+    size_t allocs;
+    size_t frees;
+    size_t reallocs;
+    size_t outstanding;
+    size_t budget; // bytes left before we start saying no
+} counting_allocator_t;
+
+void *counting_alloc(void *context, size_t bytes) {
+    counting_allocator_t *const counter = (counting_allocator_t *) context;
+    if (bytes > counter->budget) {
+        return NULL;
+    }
+    void *const ptr = malloc(bytes);
+    if (ptr) {
+        counter->budget -= bytes;
+        counter->outstanding += bytes;
+        ++counter->allocs;
+    }
+    return ptr;
+}
+
+void *counting_realloc(void *context, void *ptr, size_t old_bytes, size_t new_bytes) {
+    counting_allocator_t *const counter = (counting_allocator_t *) context;
+    if (new_bytes > old_bytes && new_bytes - old_bytes > counter->budget) {
+        return NULL;
+    }
+    void *const new_ptr = realloc(ptr, new_bytes);
+    if (new_ptr) {
+        counter->budget = counter->budget + old_bytes - new_bytes;
+        counter->outstanding = counter->outstanding - old_bytes + new_bytes;
+        ++counter->reallocs;
+    }
+    return new_ptr;
+}
+
+void counting_free(void *context, void *ptr, size_t bytes) {
+    counting_allocator_t *const counter = (counting_allocator_t *) context;
+    free(ptr);
+    counter->budget += bytes;
+    counter->outstanding -= bytes;
+    ++counter->frees;
+}
+
+// Hands out slices of one block, never takes anything back
+typedef struct {
+    uint8_t block[4096] __attribute__((aligned(16)));
+    size_t used;
+} bump_arena_t;
+
+void *bump_alloc(void *context, size_t bytes) {
+    bump_arena_t *const arena = (bump_arena_t *) context;
+    bytes = (bytes + 15) & ~((size_t) 15);
+    if (bytes > sizeof(arena->block) - arena->used) {
+        return NULL;
+    }
+    void *const ptr = arena->block + arena->used;
+    arena->used += bytes;
+    return ptr;
+}
+
 void init_data_blocks() {
     memset(DATA_BLOCKS[0], 0x11, 100);
     memset(DATA_BLOCKS[1], 0x22, 100);
@@ -252,6 +618,72 @@ void run_basic_tests_d();
 // SORT and INSERT_SORTED
 void run_basic_tests_e();
 
+// LOWER_BOUND, UPPER_BOUND, EQUAL_RANGE, BSEARCH, INSERT_SORTED_STABLE
+void run_basic_tests_f();
+
+// PUSH/POP_FRONT_N, PUSH/POP_BACK_N, INSERT_N, ERASE_N, EXTRACT_N, APPEND, APPEND_RANGE
+void run_basic_tests_g();
+
+// RESERVE, SHRINK_TO_FIT, SET_GROWTH
+void run_basic_tests_h();
+
+// SET_RING_MODE
+void run_basic_tests_i();
+
+// PRUNE
+void run_basic_tests_j();
+
+// SORT_STABLE, sort engine
+void run_basic_tests_k();
+
+// SORT_RADIX
+void run_basic_tests_l();
+
+// SORT_PARALLEL
+void run_basic_tests_m();
+
+// FOR_EACH_PARALLEL, REDUCE_PARALLEL
+void run_basic_tests_n();
+
+// FOR_EACH_SPAN
+void run_basic_tests_o();
+
+// DYN_ARRAY_DEFINE
+void run_basic_tests_p();
+
+// Size specialized kernels
+void run_basic_tests_q();
+
+// CREATE_WITH_ALLOCATOR
+void run_basic_tests_r();
+
+// INIT_INLINE
+void run_basic_tests_s();
+
+// SEGMENTED
+void run_basic_tests_t();
+
+// Default allocator
+void run_basic_tests_u();
+
+// SAVE, MAP
+void run_basic_tests_v();
+
+// HEAPIFY, HEAP_PUSH, HEAP_POP, HEAP_EXTRACT, HEAP_TOP, HEAP_UPDATE, SET_HEAP_ARITY
+void run_basic_tests_w();
+
+// IS_SORTED, FIND, CONTAINS, SORTED flag
+void run_basic_tests_x();
+
+// UNIQUE, MERGE, SET_UNION, SET_INTERSECTION, SET_DIFFERENCE
+void run_basic_tests_y();
+
+// ERASE_UNORDERED, EXTRACT_UNORDERED
+void run_basic_tests_z();
+
+// NTH_ELEMENT, PARTIAL_SORT, TOP_K, selection engine
+void run_basic_tests_aa();
+
 void run_tests() {
     init_data_blocks();
 
@@ -270,6 +702,72 @@ void run_tests() {
     // SORT INSERT_SORTED
     run_basic_tests_e();
 
+    // LOWER_BOUND, UPPER_BOUND, EQUAL_RANGE, BSEARCH, INSERT_SORTED_STABLE
+    run_basic_tests_f();
+
+    // PUSH/POP_FRONT_N, PUSH/POP_BACK_N, INSERT_N, ERASE_N, EXTRACT_N, APPEND, APPEND_RANGE
+    run_basic_tests_g();
+
+    // RESERVE, SHRINK_TO_FIT, SET_GROWTH
+    run_basic_tests_h();
+
+    // SET_RING_MODE
+    run_basic_tests_i();
+
+    // PRUNE
+    run_basic_tests_j();
+
+    // SORT_STABLE, sort engine
+    run_basic_tests_k();
+
+    // SORT_RADIX
+    run_basic_tests_l();
+
+    // SORT_PARALLEL
+    run_basic_tests_m();
+
+    // FOR_EACH_PARALLEL, REDUCE_PARALLEL
+    run_basic_tests_n();
+
+    // FOR_EACH_SPAN
+    run_basic_tests_o();
+
+    // DYN_ARRAY_DEFINE
+    run_basic_tests_p();
+
+    // Size specialized kernels
+    run_basic_tests_q();
+
+    // CREATE_WITH_ALLOCATOR
+    run_basic_tests_r();
+
+    // INIT_INLINE
+    run_basic_tests_s();
+
+    // SEGMENTED
+    run_basic_tests_t();
+
+    // Default allocator
+    run_basic_tests_u();
+
+    // SAVE, MAP
+    run_basic_tests_v();
+
+    // HEAPIFY, HEAP_PUSH, HEAP_POP, HEAP_EXTRACT, HEAP_TOP, HEAP_UPDATE, SET_HEAP_ARITY
+    run_basic_tests_w();
+
+    // IS_SORTED, FIND, CONTAINS, SORTED flag
+    run_basic_tests_x();
+
+    // UNIQUE, MERGE, SET_UNION, SET_INTERSECTION, SET_DIFFERENCE
+    run_basic_tests_y();
+
+    // ERASE_UNORDERED, EXTRACT_UNORDERED
+    run_basic_tests_z();
+
+    // NTH_ELEMENT, PARTIAL_SORT, TOP_K, selection engine
+    run_basic_tests_aa();
+
     puts("TESTS COMPLETE");
 }
 
@@ -1139,4 +1637,2702 @@ void run_basic_tests_e() {
     // FOR EACH tested and cleared for use
 
     dyn_array_destroy(dyn_a);
-}
\ No newline at end of file
+}
+
+// LOWER_BOUND, UPPER_BOUND, EQUAL_RANGE, BSEARCH, INSERT_SORTED_STABLE
+void run_basic_tests_f() {
+    dyn_array_t *dyn_a = NULL;
+    size_t first = 0, last = 0;
+    int needle = 0;
+
+    // 0 2 4 6 6 6 ... (a long run of 6s) ... 8 10
+    const int contents[] = {0, 2, 4, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 8, 10};
+    const size_t content_count = sizeof(contents) / sizeof(int);
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+
+    // 2 LOWER_BOUND/UPPER_BOUND
+    needle = 5;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 0);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 0);
+    // 2 EQUAL_RANGE
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, &first, &last));
+    assert(first == 0 && last == 0);
+    // 2 BSEARCH
+    assert(dyn_array_bsearch(dyn_a, &needle, &int_compare) == NULL);
+
+    dyn_array_destroy(dyn_a);
+    assert((dyn_a = dyn_array_import(contents, content_count, sizeof(int), NULL)));
+
+    // 1 LOWER_BOUND/UPPER_BOUND
+    needle = -1;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 0);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 0);
+    needle = 0;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 0);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 1);
+    needle = 3;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 2);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 2);
+    needle = 6;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 3);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 15);
+    needle = 10;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == 16);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == 17);
+    needle = 11;
+    assert(dyn_array_lower_bound(dyn_a, &needle, &int_compare) == content_count);
+    assert(dyn_array_upper_bound(dyn_a, &needle, &int_compare) == content_count);
+
+    // 3, 4 & 5 LOWER_BOUND/UPPER_BOUND
+    assert(dyn_array_lower_bound(NULL, &needle, &int_compare) == SIZE_MAX);
+    assert(dyn_array_upper_bound(NULL, &needle, &int_compare) == SIZE_MAX);
+    assert(dyn_array_lower_bound(dyn_a, NULL, &int_compare) == SIZE_MAX);
+    assert(dyn_array_upper_bound(dyn_a, NULL, &int_compare) == SIZE_MAX);
+    assert(dyn_array_lower_bound(dyn_a, &needle, NULL) == SIZE_MAX);
+    assert(dyn_array_upper_bound(dyn_a, &needle, NULL) == SIZE_MAX);
+
+    // 1 EQUAL_RANGE
+    needle = 6;
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, &first, &last));
+    assert(first == 3 && last == 15);
+    needle = 8;
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, &first, &last));
+    assert(first == 15 && last == 16);
+
+    // 2 EQUAL_RANGE
+    needle = 7;
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, &first, &last));
+    assert(first == 15 && last == 15);
+
+    // 3 EQUAL_RANGE
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, NULL, &last) == false);
+    assert(dyn_array_equal_range(dyn_a, &needle, &int_compare, &first, NULL) == false);
+
+    // 4 EQUAL_RANGE
+    assert(dyn_array_equal_range(NULL, &needle, &int_compare, &first, &last) == false);
+
+    // 1 BSEARCH
+    needle = 6;
+    assert(dyn_array_bsearch(dyn_a, &needle, &int_compare) == dyn_array_at(dyn_a, 3));
+    needle = 10;
+    assert(dyn_array_bsearch(dyn_a, &needle, &int_compare) == dyn_array_back(dyn_a));
+
+    // 2 BSEARCH
+    needle = 5;
+    assert(dyn_array_bsearch(dyn_a, &needle, &int_compare) == NULL);
+    needle = 11;
+    assert(dyn_array_bsearch(dyn_a, &needle, &int_compare) == NULL);
+
+    // 3 BSEARCH
+    assert(dyn_array_bsearch(NULL, &needle, &int_compare) == NULL);
+
+    dyn_array_destroy(dyn_a);
+
+    // 1 INSERT_SORTED_STABLE
+    // sorted on the first byte, second byte is the order they went in
+    assert((dyn_a = dyn_array_create(0, 2, NULL)));
+    const uint8_t tagged[5][2] = {{0x22, 0}, {0x11, 1}, {0x22, 2}, {0x33, 3}, {0x22, 4}};
+    for (int i = 0; i < 5; ++i) {
+        assert(dyn_array_insert_sorted_stable(dyn_a, tagged[i], &block_compare));
+    }
+    assert(((uint8_t *)dyn_array_at(dyn_a, 0))[1] == 1);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 1))[1] == 0);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 2))[1] == 2);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 3))[1] == 4);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 4))[1] == 3);
+
+    // and the regular one puts equals up front
+    assert(dyn_array_insert_sorted(dyn_a, tagged[0], &block_compare));
+    assert(((uint8_t *)dyn_array_at(dyn_a, 1))[1] == 0);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 2))[1] == 0);
+    assert(((uint8_t *)dyn_array_at(dyn_a, 3))[1] == 2);
+    assert(dyn_a->size == 6);
+
+    // 2, 3 & 4 INSERT_SORTED_STABLE
+    assert(dyn_array_insert_sorted_stable(NULL, tagged[0], &block_compare) == false);
+    assert(dyn_array_insert_sorted_stable(dyn_a, NULL, &block_compare) == false);
+    assert(dyn_array_insert_sorted_stable(dyn_a, tagged[0], NULL) == false);
+    assert(dyn_a->size == 6);
+
+    dyn_array_destroy(dyn_a);
+}
+
+// checks the int array against the expected contents
+bool int_contents_match(const dyn_array_t *const dyn_array, const int *const expected, const size_t count) {
+    return dyn_array_size(dyn_array) == count && (count == 0 || memcmp(dyn_array->array, expected, count * sizeof(int)) == 0);
+}
+
+// PUSH/POP_FRONT_N, PUSH/POP_BACK_N, INSERT_N, ERASE_N, EXTRACT_N, APPEND, APPEND_RANGE
+void run_basic_tests_g() {
+    dyn_array_t *dyn_a = NULL, *dyn_b = NULL;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    int extraction_point[20];
+    destruct_counter = 0;
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert((dyn_b = dyn_array_create(0, sizeof(int), &block_destructor_mini)));
+
+    // 1 PUSH_BACK_N
+    assert(dyn_array_push_back_n(dyn_a, numbers + 4, 4));
+    assert(int_contents_match(dyn_a, numbers + 4, 4));
+
+    // 1 PUSH_FRONT_N
+    assert(dyn_array_push_front_n(dyn_a, numbers, 2));
+    // 1 INSERT_N
+    assert(dyn_array_insert_n(dyn_a, 2, numbers + 2, 2));
+    assert(int_contents_match(dyn_a, numbers, 8));
+
+    // 2 PUSH_BACK_N
+    assert(dyn_a->capacity == 16);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 8, 12));
+    assert(int_contents_match(dyn_a, numbers, 20));
+    assert(dyn_a->capacity == 32);
+
+    // 3 PUSH_FRONT_N, PUSH_BACK_N, INSERT_N
+    assert(dyn_array_push_front_n(dyn_a, numbers, 0) == false);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 0) == false);
+    assert(dyn_array_insert_n(dyn_a, 0, numbers, 0) == false);
+
+    // 4 PUSH_FRONT_N, PUSH_BACK_N, INSERT_N
+    assert(dyn_array_push_front_n(dyn_a, NULL, 1) == false);
+    assert(dyn_array_push_back_n(dyn_a, NULL, 1) == false);
+    assert(dyn_array_insert_n(dyn_a, 0, NULL, 1) == false);
+
+    // 5 PUSH_FRONT_N, PUSH_BACK_N, INSERT_N
+    assert(dyn_array_push_front_n(NULL, numbers, 1) == false);
+    assert(dyn_array_push_back_n(NULL, numbers, 1) == false);
+    assert(dyn_array_insert_n(NULL, 0, numbers, 1) == false);
+
+    // 6 PUSH_FRONT_N, PUSH_BACK_N, INSERT_N
+    assert(dyn_array_push_back_n(dyn_a, numbers, DYN_MAX_CAPACITY - 19) == false);
+    assert(dyn_array_push_front_n(dyn_a, numbers, SIZE_MAX) == false);
+    assert(dyn_array_insert_n(dyn_a, 1, numbers, SIZE_MAX - 10) == false);
+
+    // 7 INSERT_N
+    assert(dyn_array_insert_n(dyn_a, 21, numbers, 1) == false);
+    assert(int_contents_match(dyn_a, numbers, 20));
+
+    // 1 POP_FRONT_N, POP_BACK_N, ERASE_N
+    assert(dyn_array_pop_front_n(dyn_a, 2));
+    assert(int_contents_match(dyn_a, numbers + 2, 18));
+    assert(dyn_array_pop_back_n(dyn_a, 3));
+    assert(int_contents_match(dyn_a, numbers + 2, 15));
+    assert(dyn_array_erase_n(dyn_a, 2, 10));
+    assert(dyn_a->size == 5);
+    assert(*((int *)dyn_array_at(dyn_a, 1)) == 3);
+    assert(*((int *)dyn_array_at(dyn_a, 2)) == 14);
+
+    // 3 POP_FRONT_N, POP_BACK_N, ERASE_N
+    assert(dyn_array_pop_front_n(dyn_a, 6) == false);
+    assert(dyn_array_pop_back_n(dyn_a, 6) == false);
+    assert(dyn_array_erase_n(dyn_a, 1, 5) == false);
+    assert(dyn_array_erase_n(dyn_a, 1, SIZE_MAX) == false);
+    assert(dyn_a->size == 5);
+
+    // 4 POP_FRONT_N, POP_BACK_N, ERASE_N
+    assert(dyn_array_pop_front_n(dyn_a, 0) == false);
+    assert(dyn_array_pop_back_n(dyn_a, 0) == false);
+    assert(dyn_array_erase_n(dyn_a, 0, 0) == false);
+
+    // 5 POP_FRONT_N, POP_BACK_N, ERASE_N
+    assert(dyn_array_pop_front_n(NULL, 1) == false);
+    assert(dyn_array_pop_back_n(NULL, 1) == false);
+    assert(dyn_array_erase_n(NULL, 0, 1) == false);
+
+    // 2 POP_FRONT_N, POP_BACK_N, ERASE_N
+    assert(dyn_array_push_back_n(dyn_b, numbers, 10));
+    assert(dyn_array_pop_front_n(dyn_b, 2));
+    assert(destruct_counter == 2);
+    assert(dyn_array_pop_back_n(dyn_b, 3));
+    assert(destruct_counter == 5);
+    assert(dyn_array_erase_n(dyn_b, 1, 3));
+    assert(destruct_counter == 8);
+    assert(dyn_b->size == 2);
+    assert(*((int *)dyn_array_at(dyn_b, 0)) == 2);
+    assert(*((int *)dyn_array_at(dyn_b, 1)) == 6);
+    destruct_counter = 0;
+
+    // 1 EXTRACT_N
+    dyn_array_clear(dyn_b);
+    destruct_counter = 0;
+    assert(dyn_array_push_back_n(dyn_b, numbers, 10));
+    assert(dyn_array_extract_n(dyn_b, 3, extraction_point, 4));
+    assert(memcmp(extraction_point, numbers + 3, 4 * sizeof(int)) == 0);
+    assert(dyn_b->size == 6);
+    assert(*((int *)dyn_array_at(dyn_b, 3)) == 7);
+    assert(destruct_counter == 0);
+
+    // 2 EXTRACT_N
+    assert(dyn_array_extract_n(dyn_b, 3, extraction_point, 4) == false);
+    assert(dyn_array_extract_n(dyn_b, 6, extraction_point, 1) == false);
+    assert(dyn_array_extract_n(dyn_b, 3, extraction_point, SIZE_MAX - 1) == false);
+    assert(dyn_b->size == 6);
+
+    // 3 EXTRACT_N
+    assert(dyn_array_extract_n(dyn_b, 0, NULL, 1) == false);
+
+    // 4 EXTRACT_N
+    assert(dyn_array_extract_n(NULL, 0, extraction_point, 1) == false);
+
+    dyn_array_destroy(dyn_b);
+    destruct_counter = 0;
+
+    // 1 APPEND
+    dyn_array_clear(dyn_a);
+    assert((dyn_b = dyn_array_import(numbers + 5, 15, sizeof(int), NULL)));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 5));
+    assert(dyn_array_append(dyn_a, dyn_b));
+    assert(int_contents_match(dyn_a, numbers, 20));
+    assert(int_contents_match(dyn_b, numbers + 5, 15));
+
+    // 2 APPEND
+    dyn_array_clear(dyn_b);
+    assert(dyn_array_append(dyn_a, dyn_b));
+    assert(int_contents_match(dyn_a, numbers, 20));
+
+    // 3 APPEND
+    // (fresh array so the append has to reallocate)
+    dyn_array_destroy(dyn_a);
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+    assert(dyn_a->capacity == 16);
+    assert(dyn_array_append(dyn_a, dyn_a));
+    assert(dyn_a->size == 20);
+    assert(memcmp(dyn_array_at(dyn_a, 10), numbers, 10 * sizeof(int)) == 0);
+
+    // 4 APPEND
+    assert(dyn_array_append_range(dyn_b, dyn_a, 5, 10));
+    assert(dyn_b->size == 10);
+    assert(memcmp(dyn_array_at(dyn_b, 0), numbers + 5, 5 * sizeof(int)) == 0);
+    assert(memcmp(dyn_array_at(dyn_b, 5), numbers, 5 * sizeof(int)) == 0);
+
+    // 5 APPEND
+    assert(dyn_array_append_range(dyn_b, dyn_a, 15, 6) == false);
+    assert(dyn_array_append_range(dyn_b, dyn_a, 21, 1) == false);
+    assert(dyn_array_append_range(dyn_b, dyn_a, 0, 0) == false);
+    assert(dyn_array_append_range(dyn_b, dyn_a, 1, SIZE_MAX) == false);
+    assert(dyn_b->size == 10);
+
+    dyn_array_destroy(dyn_b);
+
+    // 6 APPEND
+    assert((dyn_b = dyn_array_create(0, 1, NULL)));
+    assert(dyn_array_append(dyn_b, dyn_a) == false);
+    assert(dyn_array_append_range(dyn_b, dyn_a, 0, 1) == false);
+    assert(dyn_b->size == 0);
+
+    // 7 APPEND
+    assert(dyn_array_append(NULL, dyn_a) == false);
+    assert(dyn_array_append(dyn_a, NULL) == false);
+    assert(dyn_array_append_range(NULL, dyn_a, 0, 1) == false);
+    assert(dyn_array_append_range(dyn_a, NULL, 0, 1) == false);
+
+    dyn_array_destroy(dyn_a);
+    dyn_array_destroy(dyn_b);
+}
+
+// RESERVE, SHRINK_TO_FIT, SET_GROWTH
+void run_basic_tests_h() {
+    dyn_array_t *dyn_a = NULL;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+
+    // 1 RESERVE
+    assert(dyn_array_reserve(dyn_a, 37));
+    assert(dyn_a->capacity == 37);
+    assert(int_contents_match(dyn_a, numbers, 10));
+
+    // 2 RESERVE
+    assert(dyn_array_reserve(dyn_a, 20));
+    assert(dyn_a->capacity == 37);
+
+    // 3 RESERVE
+    assert(dyn_array_reserve(dyn_a, DYN_MAX_CAPACITY + 1) == false);
+    assert(dyn_a->capacity == 37);
+
+    // 4 RESERVE
+    assert(dyn_array_reserve(NULL, 10) == false);
+
+    // 1 SHRINK_TO_FIT
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_a->capacity == 10);
+    assert(int_contents_match(dyn_a, numbers, 10));
+
+    // 3 SHRINK_TO_FIT
+    // back on the power of two track instead of 10 -> 20 -> 40...
+    assert(dyn_array_push_back(dyn_a, numbers + 10));
+    assert(dyn_a->capacity == 16);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 11, 9));
+    assert(dyn_a->capacity == 32);
+    assert(int_contents_match(dyn_a, numbers, 20));
+
+    // 2 SHRINK_TO_FIT
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_a->capacity == 1);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 3));
+    assert(dyn_a->capacity == 16);
+
+    // 4 SHRINK_TO_FIT
+    assert(dyn_array_shrink_to_fit(NULL) == false);
+
+    dyn_array_destroy(dyn_a);
+
+    // 1 SET_GROWTH
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_growth(dyn_a, DYN_GROW_HALF, 0));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 17));
+    assert(dyn_a->capacity == 32); // 16 + 16, half of 16 is under the minimum step
+    assert(dyn_array_push_back_n(dyn_a, numbers, 16));
+    assert(dyn_a->capacity == 48);
+    assert(dyn_array_push_back(dyn_a, numbers));
+    assert(dyn_a->capacity == 48);
+
+    // 2 SET_GROWTH
+    assert(dyn_array_set_growth(dyn_a, DYN_GROW_EXACT, 0));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 15));
+    assert(dyn_a->capacity == 49);
+    assert(dyn_a->size == 49);
+    assert(dyn_array_push_back(dyn_a, numbers));
+    assert(dyn_a->capacity == 50);
+
+    dyn_array_destroy(dyn_a);
+
+    // 3 SET_GROWTH
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_growth(dyn_a, DYN_GROW_DOUBLE, 4));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 17));
+    assert(dyn_a->capacity == 20);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+    assert(dyn_a->capacity == 28);
+
+    // 4 SET_GROWTH
+    assert(dyn_array_set_growth(dyn_a, DYN_GROW_HALF, 0));
+    // 28 -> 44 -> 66, which gets clamped
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(dyn_a->capacity == DYN_MAX_CAPACITY);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 17));
+    assert(dyn_array_push_back(dyn_a, numbers) == false);
+    assert(dyn_a->size == DYN_MAX_CAPACITY);
+
+    // 5 SET_GROWTH
+    assert(dyn_array_set_growth(dyn_a, (DYN_GROWTH_POLICY) 0x0F, 0) == false);
+    assert(dyn_a->growth == DYN_GROW_HALF);
+
+    // 6 SET_GROWTH
+    assert(dyn_array_set_growth(NULL, DYN_GROW_HALF, 0) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+int int_sum = 0;
+void int_summer(void *const num, void *arg) {
+    int_sum += *((int *)num) * (arg ? *((int *)arg) : 1);
+}
+
+// checks the logical contents one at a time, since the storage may be wrapped
+bool int_ring_match(const dyn_array_t *const dyn_array, const int *const expected, const size_t count) {
+    if (dyn_array_size(dyn_array) != count) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (*((int *)dyn_array_at(dyn_array, i)) != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// SET_RING_MODE
+void run_basic_tests_i() {
+    dyn_array_t *dyn_a = NULL;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    int expected[40];
+    int extraction_point[20];
+    destruct_counter = 0;
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+
+    // 8 SET_RING_MODE
+    assert(dyn_array_set_ring_mode(NULL, true) == false);
+
+    // 1 SET_RING_MODE
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, numbers + 2, 3));
+    void *const old_front = dyn_array_front(dyn_a);
+    assert(dyn_array_push_front(dyn_a, numbers + 1));
+    assert(dyn_array_push_front(dyn_a, numbers));
+    // nothing moved, the new ones went on the end of the array
+    assert(dyn_array_at(dyn_a, 2) == old_front);
+    assert(dyn_a->head == 14);
+    assert(int_ring_match(dyn_a, numbers, 5));
+
+    // 3 SET_RING_MODE
+    assert(*((int *)dyn_array_front(dyn_a)) == 0);
+    assert(*((int *)dyn_array_back(dyn_a)) == 4);
+    assert(dyn_array_at(dyn_a, 5) == NULL);
+    int_sum = 0;
+    assert(dyn_array_for_each(dyn_a, &int_summer, NULL));
+    assert(int_sum == 0 + 1 + 2 + 3 + 4);
+
+    dyn_array_clear(dyn_a);
+    assert(dyn_a->size == 0);
+
+    // 2 SET_RING_MODE
+    // sliding window of 5 around a 16 object array, over and over
+    assert(dyn_array_push_back_n(dyn_a, numbers, 5));
+    for (int i = 5; i < 200; ++i) {
+        int value = i;
+        assert(dyn_array_push_back(dyn_a, &value));
+        assert(dyn_array_extract_front(dyn_a, &value));
+        assert(value == i - 5);
+        assert(*((int *)dyn_array_front(dyn_a)) == i - 4);
+        assert(*((int *)dyn_array_back(dyn_a)) == i);
+    }
+    assert(dyn_a->capacity == 16);
+    assert(dyn_a->size == 5);
+
+    // 4 SET_RING_MODE
+    // get it wrapped, then grow it
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+    assert(dyn_array_pop_front_n(dyn_a, 8));
+    assert(dyn_array_push_back_n(dyn_a, numbers + 10, 10));
+    assert(dyn_a->head + dyn_a->size > dyn_a->capacity); // wrapped
+    assert(int_ring_match(dyn_a, numbers + 8, 12));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 8)); // 20 objects, had to grow
+    assert(dyn_a->capacity == 32);
+    assert(int_ring_match(dyn_a, numbers, 20));
+
+    int_sum = 0;
+    assert(dyn_array_for_each(dyn_a, &int_summer, NULL));
+    assert(int_sum == 190);
+
+    // 6 SET_RING_MODE
+    assert(dyn_array_extract_n(dyn_a, 0, extraction_point, 3));
+    assert(memcmp(extraction_point, numbers, 3 * sizeof(int)) == 0);
+    assert(dyn_array_extract_n(dyn_a, 14, extraction_point, 3));
+    assert(memcmp(extraction_point, numbers + 17, 3 * sizeof(int)) == 0);
+    assert(int_ring_match(dyn_a, numbers + 3, 14));
+    assert(dyn_array_extract_n(dyn_a, 10, extraction_point, 5) == false);
+
+    // 5 SET_RING_MODE
+    // middle insert
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 4, 4));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 4));
+    assert(dyn_a->head != 0);
+    int value = 100;
+    assert(dyn_array_insert(dyn_a, 2, &value));
+    memcpy(expected, numbers, 2 * sizeof(int));
+    expected[2] = 100;
+    memcpy(expected + 3, numbers + 2, 6 * sizeof(int));
+    assert(int_ring_match(dyn_a, expected, 9));
+    assert(dyn_array_erase(dyn_a, 2));
+    assert(int_ring_match(dyn_a, numbers, 8));
+
+    // and ring mode picks right back up
+    assert(dyn_array_push_front(dyn_a, &value));
+    assert(dyn_a->head == dyn_a->capacity - 1);
+
+    // sort
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_a->head == 0);
+    assert(dyn_a->size == 9);
+    assert(memcmp(dyn_a->array, numbers, 8 * sizeof(int)) == 0);
+    assert(*((int *)dyn_array_back(dyn_a)) == 100);
+
+    // insert_sorted and the binary searches, wrapped
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 4, 4));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 4));
+    assert(dyn_a->head != 0);
+    value = 8;
+    assert(dyn_array_lower_bound(dyn_a, &value, &int_compare) == 8);
+    value = 3;
+    assert(dyn_array_bsearch(dyn_a, &value, &int_compare) == dyn_array_at(dyn_a, 3));
+    assert(dyn_array_insert_sorted(dyn_a, &value, &int_compare));
+    assert(dyn_a->size == 9);
+    assert(*((int *)dyn_array_at(dyn_a, 3)) == 3 && *((int *)dyn_array_at(dyn_a, 4)) == 3);
+
+    // export
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 4, 6));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 4));
+    assert(dyn_a->head != 0);
+    assert(memcmp(dyn_array_export(dyn_a), numbers, 10 * sizeof(int)) == 0);
+    assert(dyn_a->head == 0);
+    assert(dyn_array_export(dyn_a) == dyn_a->array);
+
+    // 7 SET_RING_MODE
+    assert(dyn_array_push_front_n(dyn_a, numbers, 1));
+    assert(dyn_a->head != 0);
+    assert(dyn_array_set_ring_mode(dyn_a, false));
+    assert(dyn_a->head == 0);
+    assert(*((int *)dyn_a->array) == 0);
+    assert(memcmp(dyn_array_at(dyn_a, 1), numbers, 10 * sizeof(int)) == 0);
+    // and push_front is back to the old shifting behavior
+    assert(dyn_array_push_front(dyn_a, numbers + 19));
+    assert(dyn_array_front(dyn_a) == dyn_a->array);
+
+    dyn_array_destroy(dyn_a);
+
+    // 6 SET_RING_MODE
+    assert((dyn_a = dyn_array_create(0, sizeof(int), &block_destructor_mini)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 10, 5));
+    assert(dyn_array_pop_front_n(dyn_a, 7));
+    assert(destruct_counter == 7);
+    assert(dyn_array_pop_back_n(dyn_a, 2));
+    assert(destruct_counter == 9);
+    assert(int_ring_match(dyn_a, numbers + 2, 6));
+    dyn_array_destroy(dyn_a);
+    assert(destruct_counter == 15);
+    destruct_counter = 0;
+
+    // rotation fallback, [C][D][E][A][B] with the front run up against the wrapped run
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    const int rotated[5] = {2, 3, 4, 0, 1};
+    assert(dyn_array_push_back_n(dyn_a, rotated, 5));
+    dyn_reverse(dyn_a, 0, 3);
+    dyn_reverse(dyn_a, 3, 5);
+    dyn_reverse(dyn_a, 0, 5);
+    assert(int_contents_match(dyn_a, numbers, 5));
+    dyn_array_destroy(dyn_a);
+}
+
+// removes multiples of *arg (or everything if arg is NULL)
+bool int_multiple_of(const void *const num, void *arg) {
+    return arg ? *((const int *)num) % *((int *)arg) == 0 : true;
+}
+
+// PRUNE
+void run_basic_tests_j() {
+    dyn_array_t *dyn_a = NULL;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    const int odds[10] = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    const int not_threes[13] = {1, 2, 4, 5, 7, 8, 10, 11, 13, 14, 16, 17, 19};
+    int divisor = 2;
+    destruct_counter = 0;
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+
+    // 5 PRUNE
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, &divisor) == 0);
+    assert(dyn_a->size == 0);
+
+    // 1 PRUNE
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, &divisor) == 10);
+    assert(int_contents_match(dyn_a, odds, 10));
+
+    // 3 PRUNE
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, &divisor) == 0);
+    assert(int_contents_match(dyn_a, odds, 10));
+
+    // 4 PRUNE
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, NULL) == 10);
+    assert(dyn_a->size == 0);
+
+    // 7 PRUNE
+    assert(dyn_array_prune(NULL, &int_multiple_of, &divisor) == 0);
+
+    // 8 PRUNE
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(dyn_array_prune(dyn_a, NULL, &divisor) == 0);
+    assert(int_contents_match(dyn_a, numbers, 20));
+
+    // 6 PRUNE
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_pop_back_n(dyn_a, 5));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 15, 5));
+    divisor = 3;
+    // 15 16 17 18 19 0 1 2 ... 14
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, &divisor) == 7);
+    assert(dyn_a->size == 13);
+    assert(*((int *)dyn_array_front(dyn_a)) == 16);
+    assert(*((int *)dyn_array_at(dyn_a, 3)) == 1);
+    assert(*((int *)dyn_array_back(dyn_a)) == 14);
+
+    dyn_array_destroy(dyn_a);
+
+    // 2 PRUNE
+    assert((dyn_a = dyn_array_create(0, sizeof(int), &block_destructor_mini)));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(dyn_array_prune(dyn_a, &int_multiple_of, &divisor) == 7);
+    assert(destruct_counter == 7);
+    assert(int_contents_match(dyn_a, not_threes, 13));
+
+    dyn_array_destroy(dyn_a);
+    destruct_counter = 0;
+}
+
+// Sort engine test records are a key followed by filler
+// Filler is either derived from the key (so any correct sort matches qsort byte for byte)
+// or the record's original position (so the stable sort can be checked)
+#define SORT_TEST_COUNT 5000
+#define SORT_TEST_MAX_SIZE 40
+
+void fill_sort_records(uint8_t *records, const size_t size, const int *keys, const bool tag_position) {
+    for (size_t idx = 0; idx < SORT_TEST_COUNT; ++idx, records += size) {
+        memset(records, keys[idx] & 0xFF, size);
+        memcpy(records, keys + idx, sizeof(int));
+        if (tag_position && size >= 2 * sizeof(int)) {
+            const int position = (int) idx;
+            memcpy(records + sizeof(int), &position, sizeof(int));
+        }
+    }
+}
+
+bool sort_records_stable(const uint8_t *records, const size_t size) {
+    for (size_t idx = 1; idx < SORT_TEST_COUNT; ++idx, records += size) {
+        int keys[2], positions[2];
+        memcpy(keys, records, sizeof(int));
+        memcpy(keys + 1, records + size, sizeof(int));
+        memcpy(positions, records + sizeof(int), sizeof(int));
+        memcpy(positions + 1, records + size + sizeof(int), sizeof(int));
+        if (keys[0] > keys[1] || (keys[0] == keys[1] && positions[0] > positions[1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// SORT_STABLE, sort engine
+void run_basic_tests_k() {
+    dyn_array_t *dyn_a = NULL;
+    const size_t sizes[6] = {4, 8, 16, 32, 12, SORT_TEST_MAX_SIZE};
+    static int keys[SORT_TEST_COUNT];
+    static uint8_t records[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE], expected[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE];
+    static uint8_t scratch[(SORT_TEST_COUNT / 2 + 1) * SORT_TEST_MAX_SIZE];
+
+    // 1, 2 sort engine
+    srand(0x5EED);
+    for (int pattern = 0; pattern < 7; ++pattern) {
+        for (int idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+            switch (pattern) {
+                case 0: keys[idx] = rand() - RAND_MAX / 2; break;
+                case 1: keys[idx] = idx; break;
+                case 2: keys[idx] = SORT_TEST_COUNT - idx; break;
+                case 3: keys[idx] = 7; break;
+                case 4: keys[idx] = rand() % 4; break;
+                case 5: keys[idx] = idx < SORT_TEST_COUNT / 2 ? idx : SORT_TEST_COUNT - idx; break;
+                case 6: keys[idx] = idx % 100; break;
+            }
+        }
+        for (int size_idx = 0; size_idx < 6; ++size_idx) {
+            fill_sort_records(records, sizes[size_idx], keys, false);
+            memcpy(expected, records, SORT_TEST_COUNT * sizes[size_idx]);
+            qsort(expected, SORT_TEST_COUNT, sizes[size_idx], &int_compare);
+            dyn_sort_buffer(records, SORT_TEST_COUNT, sizes[size_idx], &int_compare);
+            assert(memcmp(records, expected, SORT_TEST_COUNT * sizes[size_idx]) == 0);
+
+            // 4 sort engine
+            if (sizes[size_idx] >= 2 * sizeof(int)) {
+                fill_sort_records(records, sizes[size_idx], keys, true);
+                dyn_stable_sort_buffer(records, SORT_TEST_COUNT, sizes[size_idx], &int_compare, scratch);
+                assert(sort_records_stable(records, sizes[size_idx]));
+            }
+        }
+    }
+
+    // 3 sort engine
+    {
+        dyn_sorter_t sorter;
+        dyn_sorter_init(&sorter, sizeof(int), &int_compare);
+        for (int idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+            keys[idx] = rand() % 1000;
+        }
+        memcpy(expected, keys, sizeof(keys));
+        qsort(expected, SORT_TEST_COUNT, sizeof(int), &int_compare);
+        dyn_heap_sort(&sorter, (uint8_t *) keys, SORT_TEST_COUNT);
+        assert(memcmp(keys, expected, sizeof(keys)) == 0);
+    }
+
+    // 1 SORT_STABLE
+    // sorted by the first int only, the second one is the original position
+    const int pairs[20][2] = {{3, 0}, {1, 1}, {3, 2}, {2, 3}, {1, 4}, {0, 5}, {3, 6}, {2, 7}, {1, 8}, {0, 9},
+                              {3, 10}, {1, 11}, {2, 12}, {2, 13}, {0, 14}, {1, 15}, {3, 16}, {0, 17}, {2, 18}, {1, 19}};
+    const int stable_positions[20] = {5, 9, 14, 17, 1, 4, 8, 11, 15, 19, 3, 7, 12, 13, 18, 0, 2, 6, 10, 16};
+
+    assert((dyn_a = dyn_array_create(0, sizeof(pairs[0]), NULL)));
+    assert(dyn_array_push_back_n(dyn_a, pairs, 20));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    for (size_t idx = 0; idx < 20; ++idx) {
+        assert(((int *)dyn_array_at(dyn_a, idx))[1] == stable_positions[idx]);
+    }
+
+    // 4 SORT_STABLE
+    void *const first_scratch = dyn_a->scratch;
+    assert(first_scratch);
+    assert(dyn_array_pop_back_n(dyn_a, 10));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(dyn_a->scratch == first_scratch);
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_a->scratch == NULL && dyn_a->scratch_size == 0);
+
+    // 3 SORT_STABLE
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, pairs + 10, 10));
+    assert(dyn_array_push_front_n(dyn_a, pairs, 10));
+    assert(dyn_a->head != 0);
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(dyn_a->head == 0);
+    for (size_t idx = 0; idx < 20; ++idx) {
+        assert(((int *)dyn_array_at(dyn_a, idx))[1] == stable_positions[idx]);
+    }
+
+    // 7 SORT_STABLE
+    assert(dyn_array_sort_stable(dyn_a, NULL) == false);
+
+    // 2 SORT_STABLE
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back(dyn_a, pairs[3]));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(((int *)dyn_array_front(dyn_a))[1] == 3);
+
+    // 6 SORT_STABLE
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_sort_stable(dyn_a, &int_compare) == false);
+
+    // 5 SORT_STABLE
+    assert(dyn_array_sort_stable(NULL, &int_compare) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+// Radix test records, original position up front, key at RADIX_KEY_OFFSET
+#define RADIX_RECORD_SIZE 20
+#define RADIX_KEY_OFFSET 8
+
+// -1, 0, 1 for the keys in two records, read as whatever type the test is using
+int radix_key_compare(const uint8_t *a, const uint8_t *b, const size_t key_width, const DYN_RADIX_FLAGS flags) {
+    a += RADIX_KEY_OFFSET;
+    b += RADIX_KEY_OFFSET;
+    int result = 0;
+    if (flags & DYN_RADIX_FLOAT) {
+        double x, y;
+        if (key_width == 4) {
+            float fx, fy;
+            memcpy(&fx, a, 4);
+            memcpy(&fy, b, 4);
+            x = fx;
+            y = fy;
+        } else {
+            memcpy(&x, a, 8);
+            memcpy(&y, b, 8);
+        }
+        result = (x > y) - (x < y);
+        if (!result) {
+            // radix puts -0.0 in front of 0.0
+            result = (int) signbit(y) - (int) signbit(x);
+        }
+    } else {
+        // sign extend or zero extend into 64 bits
+        uint64_t x = 0, y = 0;
+        memcpy(&x, a, key_width);
+        memcpy(&y, b, key_width);
+        if (flags & DYN_RADIX_SIGNED) {
+            const int shift = 64 - (int) key_width * 8;
+            const int64_t sx = (int64_t)(x << shift) >> shift, sy = (int64_t)(y << shift) >> shift;
+            result = (sx > sy) - (sx < sy);
+        } else {
+            result = (x > y) - (x < y);
+        }
+    }
+    return flags & DYN_RADIX_DESCENDING ? -result : result;
+}
+
+bool radix_records_sorted(const uint8_t *records, const size_t count, const size_t key_width, const DYN_RADIX_FLAGS flags) {
+    for (size_t idx = 1; idx < count; ++idx, records += RADIX_RECORD_SIZE) {
+        const int result = radix_key_compare(records, records + RADIX_RECORD_SIZE, key_width, flags);
+        int positions[2];
+        memcpy(positions, records, sizeof(int));
+        memcpy(positions + 1, records + RADIX_RECORD_SIZE, sizeof(int));
+        if (result > 0 || (result == 0 && positions[0] > positions[1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// SORT_RADIX
+void run_basic_tests_l() {
+    dyn_array_t *dyn_a = NULL;
+    static uint8_t records[SORT_TEST_COUNT * RADIX_RECORD_SIZE], scratch[SORT_TEST_COUNT * RADIX_RECORD_SIZE];
+    const struct {
+        size_t width;
+        DYN_RADIX_FLAGS flags;
+    } key_types[12] = {{1, DYN_RADIX_UNSIGNED}, {1, DYN_RADIX_SIGNED}, {2, DYN_RADIX_UNSIGNED}, {2, DYN_RADIX_SIGNED},
+                       {4, DYN_RADIX_UNSIGNED}, {4, DYN_RADIX_SIGNED}, {8, DYN_RADIX_UNSIGNED}, {8, DYN_RADIX_SIGNED},
+                       {4, DYN_RADIX_FLOAT}, {8, DYN_RADIX_FLOAT}, {4, DYN_RADIX_SIGNED | DYN_RADIX_DESCENDING},
+                       {8, DYN_RADIX_FLOAT | DYN_RADIX_DESCENDING}};
+
+    // 1 SORT_RADIX (engine, the arrays are too small to be interesting)
+    srand(0xBEEF);
+    for (int type = 0; type < 12; ++type) {
+        const size_t width = key_types[type].width;
+        const DYN_RADIX_FLAGS flags = key_types[type].flags;
+        memset(records, 0x00, sizeof(records));
+        for (int idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+            uint8_t *const record = records + idx * RADIX_RECORD_SIZE;
+            memcpy(record, &idx, sizeof(int));
+            if (flags & DYN_RADIX_FLOAT) {
+                // small range so there are plenty of ties, both signs, and a few zeros of each sign
+                const double value = (rand() % 2001 - 1000) / 8.0;
+                if (width == 4) {
+                    const float narrow = idx % 97 ? (float) value : -0.0f;
+                    memcpy(record + RADIX_KEY_OFFSET, &narrow, 4);
+                } else {
+                    memcpy(record + RADIX_KEY_OFFSET, &value, 8);
+                }
+            } else {
+                for (size_t byte = 0; byte < width; ++byte) {
+                    // low bytes vary a lot, high bytes a little, so some passes get skipped
+                    record[RADIX_KEY_OFFSET + byte] = (uint8_t)(byte < 2 ? rand() : rand() % 3 ? 0x00 : 0xFF);
+                }
+            }
+        }
+        const uint8_t *result = dyn_radix_sort_buffer(records, SORT_TEST_COUNT, RADIX_RECORD_SIZE, RADIX_KEY_OFFSET,
+                                                      width, flags, scratch) ? scratch : records;
+        assert(radix_records_sorted(result, SORT_TEST_COUNT, width, flags));
+    }
+
+    // 2 SORT_RADIX
+    // {position, pad, key (1 byte)}, 1 byte key is always one pass
+    const uint8_t small_keys[10] = {9, 3, 250, 3, 0, 128, 7, 9, 1, 3};
+    const int small_order[10] = {4, 8, 1, 3, 9, 6, 0, 7, 5, 2};
+    uint8_t record[RADIX_RECORD_SIZE];
+    memset(record, 0x00, sizeof(record));
+    assert((dyn_a = dyn_array_create(0, RADIX_RECORD_SIZE, NULL)));
+    for (int idx = 0; idx < 10; ++idx) {
+        memcpy(record, &idx, sizeof(int));
+        record[RADIX_KEY_OFFSET] = small_keys[idx];
+        assert(dyn_array_push_back(dyn_a, record));
+    }
+    assert(dyn_array_sort_radix(dyn_a, RADIX_KEY_OFFSET, 1, DYN_RADIX_UNSIGNED));
+    for (size_t idx = 0; idx < 10; ++idx) {
+        assert(*((int *)dyn_array_at(dyn_a, idx)) == small_order[idx]);
+    }
+
+    // 7 SORT_RADIX
+    assert(dyn_array_sort_radix(dyn_a, RADIX_KEY_OFFSET, 3, DYN_RADIX_UNSIGNED) == false);
+    assert(dyn_array_sort_radix(dyn_a, RADIX_KEY_OFFSET, 0, DYN_RADIX_UNSIGNED) == false);
+    assert(dyn_array_sort_radix(dyn_a, RADIX_RECORD_SIZE - 4, 8, DYN_RADIX_UNSIGNED) == false);
+    assert(dyn_array_sort_radix(dyn_a, RADIX_RECORD_SIZE, 1, DYN_RADIX_UNSIGNED) == false);
+    assert(dyn_array_sort_radix(dyn_a, SIZE_MAX, 8, DYN_RADIX_UNSIGNED) == false);
+    assert(dyn_array_sort_radix(dyn_a, RADIX_KEY_OFFSET, 2, DYN_RADIX_FLOAT) == false);
+    assert(dyn_array_sort_radix(dyn_a, RADIX_KEY_OFFSET, 4, (DYN_RADIX_FLAGS) 0x10) == false);
+
+    // 3 SORT_RADIX
+    // sort by position again, descending, with the array wrapped
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_pop_back_n(dyn_a, 4));
+    for (int idx = 10; idx < 14; ++idx) {
+        memcpy(record, &idx, sizeof(int));
+        assert(dyn_array_push_front(dyn_a, record));
+    }
+    assert(dyn_a->head != 0);
+    assert(dyn_array_sort_radix(dyn_a, 0, sizeof(int), DYN_RADIX_SIGNED | DYN_RADIX_DESCENDING));
+    assert(dyn_a->head == 0);
+    const int descending[10] = {13, 12, 11, 10, 9, 8, 6, 4, 3, 1};
+    for (size_t idx = 0; idx < 10; ++idx) {
+        assert(*((int *)dyn_array_at(dyn_a, idx)) == descending[idx]);
+    }
+
+    // 4 SORT_RADIX
+    assert(dyn_array_pop_back_n(dyn_a, 9));
+    assert(dyn_array_sort_radix(dyn_a, 0, sizeof(int), DYN_RADIX_SIGNED));
+    assert(*((int *)dyn_array_front(dyn_a)) == 13);
+
+    // 6 SORT_RADIX
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_sort_radix(dyn_a, 0, sizeof(int), DYN_RADIX_SIGNED) == false);
+
+    // 5 SORT_RADIX
+    assert(dyn_array_sort_radix(NULL, 0, sizeof(int), DYN_RADIX_SIGNED) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+// SORT_PARALLEL
+void run_basic_tests_m() {
+    dyn_array_t *dyn_a = NULL;
+    const size_t sizes[6] = {4, 8, 16, 32, 12, SORT_TEST_MAX_SIZE};
+    const size_t thread_counts[5] = {2, 3, 4, 7, 1000};
+    static int keys[SORT_TEST_COUNT];
+    static uint8_t records[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE], expected[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE];
+    static uint8_t scratch[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE];
+
+    // 1 SORT_PARALLEL (engine)
+    srand(0xCAFE);
+    for (int idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+        keys[idx] = rand() % 3000 - 1500;
+    }
+    for (int size_idx = 0; size_idx < 6; ++size_idx) {
+        fill_sort_records(expected, sizes[size_idx], keys, false);
+        qsort(expected, SORT_TEST_COUNT, sizes[size_idx], &int_compare);
+        for (int thread_idx = 0; thread_idx < 5; ++thread_idx) {
+            fill_sort_records(records, sizes[size_idx], keys, false);
+            const uint8_t *result = dyn_parallel_sort_buffer(records, SORT_TEST_COUNT, sizes[size_idx], &int_compare,
+                                                             thread_counts[thread_idx], scratch) ? scratch : records;
+            assert(memcmp(result, expected, SORT_TEST_COUNT * sizes[size_idx]) == 0);
+        }
+    }
+
+    // 1 SORT_PARALLEL
+    int numbers[60], sorted[60];
+    for (int idx = 0; idx < 60; ++idx) {
+        numbers[idx] = rand() % 50;
+    }
+    memcpy(sorted, numbers, sizeof(numbers));
+    qsort(sorted, 60, sizeof(int), &int_compare);
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    for (int thread_idx = 0; thread_idx < 5; ++thread_idx) {
+        dyn_array_clear(dyn_a);
+        assert(dyn_array_push_back_n(dyn_a, numbers, 60));
+        assert(dyn_array_sort_parallel(dyn_a, &int_compare, thread_counts[thread_idx]));
+        assert(int_contents_match(dyn_a, sorted, 60));
+    }
+
+    // 2 SORT_PARALLEL
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 60));
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 0));
+    assert(int_contents_match(dyn_a, sorted, 60));
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 60));
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 1));
+    assert(int_contents_match(dyn_a, sorted, 60));
+    // serial doesn't need the scratch buffer
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 1));
+    assert(dyn_a->scratch == NULL);
+
+    // 3 SORT_PARALLEL
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, numbers + 20, 40));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 20));
+    assert(dyn_a->head != 0);
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 4));
+    assert(int_contents_match(dyn_a, sorted, 60));
+
+    // 7 SORT_PARALLEL
+    assert(dyn_array_sort_parallel(dyn_a, NULL, 4) == false);
+
+    // 4 SORT_PARALLEL
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back(dyn_a, numbers));
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 4));
+    assert(*((int *)dyn_array_front(dyn_a)) == numbers[0]);
+
+    // 6 SORT_PARALLEL
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 4) == false);
+
+    // 5 SORT_PARALLEL
+    assert(dyn_array_sort_parallel(NULL, &int_compare, 4) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+void int_add_arg(void *const num, void *arg) {
+    *((int *)num) += *((int *)arg);
+}
+
+void int_sum_accumulate(void *const sum, const void *const num, void *arg) {
+    (void) arg;
+    *((long long *)sum) += *((const int *)num);
+}
+
+void int_sum_combine(void *const sum, const void *const other, void *arg) {
+    (void) arg;
+    *((long long *)sum) += *((const long long *)other);
+}
+
+// Tracks whether a range is sorted. Combining is associative, but order matters.
+typedef struct {
+    int first;
+    int last;
+    bool sorted;
+    bool empty;
+} sorted_run_t;
+
+void sorted_run_accumulate(void *const run_ptr, const void *const num, void *arg) {
+    sorted_run_t *const run = (sorted_run_t *) run_ptr;
+    const int value = *((const int *)num);
+    (void) arg;
+    if (run->empty) {
+        run->first = value;
+        run->empty = false;
+    } else if (value < run->last) {
+        run->sorted = false;
+    }
+    run->last = value;
+}
+
+void sorted_run_combine(void *const run_ptr, const void *const other_ptr, void *arg) {
+    sorted_run_t *const run = (sorted_run_t *) run_ptr;
+    const sorted_run_t *const other = (const sorted_run_t *) other_ptr;
+    (void) arg;
+    if (!other->empty) {
+        if (run->empty) {
+            *run = *other;
+        } else {
+            run->sorted = run->sorted && other->sorted && run->last <= other->first;
+            run->last = other->last;
+        }
+    }
+}
+
+// FOR_EACH_PARALLEL, REDUCE_PARALLEL
+void run_basic_tests_n() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[60], expected[60];
+    for (int idx = 0; idx < 60; ++idx) {
+        numbers[idx] = idx * 3;
+        expected[idx] = idx * 3 + 5;
+    }
+    int increment = 5;
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+
+    // 4 FOR_EACH_PARALLEL
+    assert(dyn_array_for_each_parallel(dyn_a, &int_add_arg, &increment, 4, 4));
+
+    // 3 REDUCE_PARALLEL
+    long long sum = 42;
+    const long long zero = 0;
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, &int_sum_combine, &sum, &zero, sizeof(sum), NULL, 4, 4));
+    assert(sum == 42);
+
+    // 1 FOR_EACH_PARALLEL
+    assert(dyn_array_push_back_n(dyn_a, numbers, 60));
+    assert(dyn_array_for_each_parallel(dyn_a, &int_add_arg, &increment, 4, 4));
+    assert(int_contents_match(dyn_a, expected, 60));
+    size_t bounds[DYN_PARALLEL_MAX_THREADS + 1];
+    assert(dyn_parallel_bounds(dyn_a, 4, 4, bounds) == 4);
+    assert(bounds[0] == 0 && bounds[4] == 60);
+    for (size_t idx = 1; idx < 4; ++idx) {
+        assert(bounds[idx] >= bounds[idx - 1]);
+        assert((uintptr_t) dyn_array_at(dyn_a, bounds[idx]) % DYN_CACHE_LINE == 0);
+    }
+
+    // 2 FOR_EACH_PARALLEL
+    increment = -5;
+    assert(dyn_array_for_each_parallel(dyn_a, &int_add_arg, &increment, 1000, 0));
+    assert(int_contents_match(dyn_a, numbers, 60));
+    assert(dyn_parallel_bounds(dyn_a, 1000, 0, bounds) == 1);
+    assert(dyn_parallel_bounds(dyn_a, 1000, 1, bounds) == 60);
+    for (size_t idx = 1; idx <= 60; ++idx) {
+        assert(bounds[idx] >= bounds[idx - 1] && bounds[idx] <= 60);
+    }
+
+    // 1 REDUCE_PARALLEL
+    sum = 0;
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, &int_sum_combine, &sum, &zero, sizeof(sum), NULL, 7, 4));
+    assert(sum == 3 * (59 * 60 / 2));
+
+    // 2 REDUCE_PARALLEL
+    const sorted_run_t empty_run = {0, 0, true, true};
+    sorted_run_t run = empty_run;
+    assert(dyn_array_reduce_parallel(dyn_a, &sorted_run_accumulate, &sorted_run_combine, &run, &empty_run,
+                                     sizeof(run), NULL, 8, 4));
+    assert(run.sorted && !run.empty && run.first == 0 && run.last == 177);
+    // break it right at the front of a later chunk, only the in-order combine can catch it
+    *((int *)dyn_array_at(dyn_a, 45)) = 0;
+    run = empty_run;
+    assert(dyn_array_reduce_parallel(dyn_a, &sorted_run_accumulate, &sorted_run_combine, &run, &empty_run,
+                                     sizeof(run), NULL, 8, 4));
+    assert(!run.sorted);
+    *((int *)dyn_array_at(dyn_a, 45)) = 135;
+
+    // 4 REDUCE_PARALLEL
+    assert(dyn_array_reduce_parallel(NULL, &int_sum_accumulate, &int_sum_combine, &sum, &zero, sizeof(sum), NULL, 4, 4) == false);
+    assert(dyn_array_reduce_parallel(dyn_a, NULL, &int_sum_combine, &sum, &zero, sizeof(sum), NULL, 4, 4) == false);
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, NULL, &sum, &zero, sizeof(sum), NULL, 4, 4) == false);
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, &int_sum_combine, NULL, &zero, sizeof(sum), NULL, 4, 4) == false);
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, &int_sum_combine, &sum, NULL, sizeof(sum), NULL, 4, 4) == false);
+    assert(dyn_array_reduce_parallel(dyn_a, &int_sum_accumulate, &int_sum_combine, &sum, &zero, 0, NULL, 4, 4) == false);
+
+    // 3 FOR_EACH_PARALLEL
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_push_back_n(dyn_a, numbers + 10, 50));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 10));
+    assert(dyn_a->head != 0);
+    increment = 5;
+    assert(dyn_array_for_each_parallel(dyn_a, &int_add_arg, &increment, 4, 4));
+    assert(int_contents_match(dyn_a, expected, 60));
+
+    // 5 FOR_EACH_PARALLEL
+    assert(dyn_array_for_each_parallel(NULL, &int_add_arg, &increment, 4, 4) == false);
+
+    // 6 FOR_EACH_PARALLEL
+    assert(dyn_array_for_each_parallel(dyn_a, NULL, &increment, 4, 4) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+// Copies each span into the int buffer at *arg and moves it along, records span sizes
+size_t span_sizes[16];
+size_t span_count = 0;
+void int_span_collect(void *const base, const size_t count, void *arg) {
+    int **const out = (int **) arg;
+    memcpy(*out, base, count * sizeof(int));
+    *out += count;
+    if (span_count < 16) {
+        span_sizes[span_count] = count;
+    }
+    ++span_count;
+}
+
+// FOR_EACH_SPAN
+void run_basic_tests_o() {
+    dyn_array_t *dyn_a = NULL;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    int collected[20], *out = collected;
+
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+
+    // 4 FOR_EACH_SPAN
+    span_count = 0;
+    assert(dyn_array_for_each_span(dyn_a, &int_span_collect, &out, 0));
+    assert(span_count == 0);
+
+    // 1 FOR_EACH_SPAN
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(dyn_array_for_each_span(dyn_a, &int_span_collect, &out, 0));
+    assert(span_count == 1 && span_sizes[0] == 20);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+
+    // 2 FOR_EACH_SPAN
+    span_count = 0;
+    out = collected;
+    memset(collected, 0x00, sizeof(collected));
+    assert(dyn_array_for_each_span(dyn_a, &int_span_collect, &out, 8));
+    assert(span_count == 3 && span_sizes[0] == 8 && span_sizes[1] == 8 && span_sizes[2] == 4);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+
+    // 3 FOR_EACH_SPAN
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, numbers + 5, 15));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 5));
+    const size_t head = dyn_a->head;
+    assert(head != 0);
+    span_count = 0;
+    out = collected;
+    memset(collected, 0x00, sizeof(collected));
+    assert(dyn_array_for_each_span(dyn_a, &int_span_collect, &out, 0));
+    assert(span_count == 2 && span_sizes[0] == 5 && span_sizes[1] == 15);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+    assert(dyn_a->head == head);
+    span_count = 0;
+    out = collected;
+    assert(dyn_array_for_each_span(dyn_a, &int_span_collect, &out, 4));
+    assert(span_count == 6 && span_sizes[0] == 4 && span_sizes[1] == 1 && span_sizes[5] == 3);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+
+    // 5 FOR_EACH_SPAN
+    assert(dyn_array_for_each_span(NULL, &int_span_collect, &out, 0) == false);
+
+    // 6 FOR_EACH_SPAN
+    assert(dyn_array_for_each_span(dyn_a, NULL, &out, 0) == false);
+
+    dyn_array_destroy(dyn_a);
+}
+
+DYN_ARRAY_DEFINE(int_array, int)
+
+// DYN_ARRAY_DEFINE
+void run_basic_tests_p() {
+    int_array_t typed;
+    int object = 0;
+    const int numbers[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+
+    // 1 DYN_ARRAY_DEFINE
+    assert(int_array_init(&typed, 0));
+    assert(typed.capacity == DYN_ARRAY_TYPED_MIN_CAPACITY && typed.size == 0);
+    for (int idx = 0; idx < 20; ++idx) {
+        assert(int_array_push_back(&typed, idx));
+    }
+    assert(typed.capacity == 32);
+    assert(memcmp(typed.data, numbers, sizeof(numbers)) == 0);
+
+    // 2 DYN_ARRAY_DEFINE
+    assert(*int_array_at(&typed, 7) == 7);
+    assert(*int_array_front(&typed) == 0 && *int_array_back(&typed) == 19);
+    assert(int_array_at(&typed, 20) == NULL);
+    *int_array_at(&typed, 7) = 70;
+    assert(typed.data[7] == 70);
+    typed.data[7] = 7;
+
+    // 3 DYN_ARRAY_DEFINE
+    assert(int_array_insert(&typed, 0, -1));
+    assert(int_array_insert(&typed, 10, -2));
+    assert(int_array_insert(&typed, 22, -3));
+    assert(typed.size == 23);
+    assert(typed.data[0] == -1 && typed.data[10] == -2 && typed.data[22] == -3);
+    assert(int_array_extract(&typed, 10, &object) && object == -2);
+    assert(int_array_erase(&typed, 21));
+    assert(int_array_erase(&typed, 0));
+    assert(memcmp(typed.data, numbers, sizeof(numbers)) == 0);
+
+    // 4 DYN_ARRAY_DEFINE
+    assert(int_array_push_front(&typed, 100));
+    assert(*int_array_front(&typed) == 100);
+    assert(int_array_extract_front(&typed, &object) && object == 100);
+    assert(int_array_pop_front(&typed));
+    assert(*int_array_front(&typed) == 1);
+    assert(int_array_extract_back(&typed, &object) && object == 19);
+    assert(int_array_pop_back(&typed));
+    assert(*int_array_back(&typed) == 17 && int_array_size(&typed) == 17);
+
+    // 6 DYN_ARRAY_DEFINE
+    dyn_array_t *dyn_a = int_array_export(&typed);
+    assert(dyn_a);
+    assert(dyn_array_size(dyn_a) == 17 && dyn_array_data_size(dyn_a) == sizeof(int));
+    assert(memcmp(dyn_array_export(dyn_a), numbers + 1, 17 * sizeof(int)) == 0);
+    assert(dyn_array_push_front(dyn_a, numbers));
+    assert(int_array_import(&typed, dyn_a));
+    assert(typed.size == 18);
+    assert(memcmp(typed.data, numbers, 18 * sizeof(int)) == 0);
+    // wrapped ring, import straightens it out
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_pop_back_n(dyn_a, 3));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 15, 3));
+    assert(int_array_import(&typed, dyn_a));
+    assert(typed.data[0] == 15 && typed.data[3] == 0 && typed.data[17] == 14);
+    dyn_array_destroy(dyn_a);
+
+    // 7 DYN_ARRAY_DEFINE
+    assert((dyn_a = dyn_array_create(0, sizeof(long long), NULL)));
+    assert(int_array_import(&typed, dyn_a) == false);
+    assert(typed.size == 18);
+    dyn_array_destroy(dyn_a);
+
+    // 5 DYN_ARRAY_DEFINE
+    assert(int_array_reserve(&typed, 10));
+    assert(typed.capacity == 32);
+    assert(int_array_reserve(&typed, 100));
+    assert(typed.capacity == 100);
+    assert(!int_array_empty(&typed));
+    int_array_clear(&typed);
+    assert(int_array_empty(&typed) && int_array_size(&typed) == 0);
+    assert(int_array_front(&typed) == NULL && int_array_back(&typed) == NULL);
+    assert((dyn_a = int_array_export(&typed)));
+    assert(dyn_array_empty(dyn_a));
+    assert(int_array_import(&typed, dyn_a));
+    dyn_array_destroy(dyn_a);
+
+    // 8 DYN_ARRAY_DEFINE
+    assert(int_array_pop_back(&typed) == false);
+    assert(int_array_pop_front(&typed) == false);
+    assert(int_array_extract_back(&typed, &object) == false);
+    assert(int_array_insert(&typed, 1, 5) == false);
+    assert(int_array_push_back(&typed, 5));
+    assert(int_array_extract(&typed, 0, NULL) == false);
+    assert(int_array_erase(&typed, 1) == false);
+    assert(int_array_init(NULL, 0) == false);
+    assert(int_array_push_back(NULL, 5) == false);
+    assert(int_array_at(NULL, 0) == NULL);
+    assert(int_array_size(NULL) == 0 && int_array_empty(NULL));
+    assert(int_array_export(NULL) == NULL);
+    assert(int_array_import(NULL, NULL) == false);
+    assert(int_array_import(&typed, NULL) == false);
+    int_array_destroy(NULL);
+
+    int_array_destroy(&typed);
+    assert(typed.data == NULL && typed.size == 0);
+}
+
+void byte_sum_walk(void *const object, void *arg) {
+    *((size_t *)arg) += ((const uint8_t *)object)[0];
+}
+
+// Size specialized kernels
+void run_basic_tests_q() {
+    const size_t sizes[9] = {1, 2, 4, 8, 16, 32, 3, 24, 100};
+    uint8_t objects[10][100], copy[10][100], out[10][100];
+    for (size_t idx = 0; idx < 10; ++idx) {
+        for (size_t byte = 0; byte < 100; ++byte) {
+            objects[idx][byte] = (uint8_t)(idx * 31 + byte + 1);
+        }
+    }
+
+    // 1 kernels
+    for (size_t idx = 0; idx < 6; ++idx) {
+        assert(dyn_select_kernels(sizes[idx]) == dyn_kernel_tables + idx);
+    }
+    assert(dyn_select_kernels(3) == dyn_kernel_tables + 6);
+    assert(dyn_select_kernels(64) == dyn_kernel_tables + 6);
+
+    for (size_t size_idx = 0; size_idx < 9; ++size_idx) {
+        const size_t size = sizes[size_idx];
+        const dyn_kernels_t *const kernels = dyn_select_kernels(size);
+
+        // 2 kernels
+        // pack the objects tight so the copies see the real stride
+        uint8_t packed[10 * 100], packed_out[10 * 100];
+        for (size_t idx = 0; idx < 10; ++idx) {
+            memcpy(packed + idx * size, objects[idx], size);
+        }
+        memset(packed_out, 0x00, sizeof(packed_out));
+        kernels->copy(packed_out, packed, 1, size);
+        assert(memcmp(packed_out, packed, size) == 0);
+        assert(packed_out[size] == 0x00);
+        kernels->copy(packed_out, packed, 10, size);
+        assert(memcmp(packed_out, packed, 10 * size) == 0);
+        kernels->swap(packed_out, packed_out + 9 * size, size);
+        assert(memcmp(packed_out, packed + 9 * size, size) == 0);
+        assert(memcmp(packed_out + 9 * size, packed, size) == 0);
+        kernels->move(packed_out, packed, size);
+        assert(memcmp(packed_out, packed, size) == 0);
+        size_t walked = 0, expected = 0;
+        kernels->walk(packed, 10, size, &byte_sum_walk, &walked);
+        for (size_t idx = 0; idx < 10; ++idx) {
+            expected += objects[idx][0];
+        }
+        assert(walked == expected);
+
+        // 3 kernels
+        dyn_array_t *dyn_a = NULL;
+        assert((dyn_a = dyn_array_create(0, size, NULL)));
+        assert(dyn_a->kernels == kernels);
+        for (int ring = 0; ring < 2; ++ring) {
+            assert(dyn_array_set_ring_mode(dyn_a, ring));
+            for (size_t idx = 0; idx < 10; ++idx) {
+                memcpy(copy[idx], objects[idx], size);
+            }
+            assert(dyn_array_push_back(dyn_a, copy[5]));
+            assert(dyn_array_push_front(dyn_a, copy[0]));
+            assert(dyn_array_insert(dyn_a, 1, copy[1]));
+            assert(dyn_array_push_back_n(dyn_a, copy[6], 1));
+            assert(dyn_array_insert_n(dyn_a, 2, packed + 2 * size, 3));
+            assert(dyn_array_push_back_n(dyn_a, packed + 7 * size, 3));
+            assert(dyn_array_size(dyn_a) == 10);
+            for (size_t idx = 0; idx < 10; ++idx) {
+                assert(memcmp(dyn_array_at(dyn_a, idx), objects[idx], size) == 0);
+            }
+            walked = 0;
+            assert(dyn_array_for_each(dyn_a, &byte_sum_walk, &walked));
+            assert(walked == expected);
+            assert(dyn_array_extract_front(dyn_a, out[0]));
+            assert(dyn_array_extract_back(dyn_a, out[9]));
+            assert(dyn_array_extract(dyn_a, 3, out[4]));
+            assert(dyn_array_extract_n(dyn_a, 0, out[1], 3));
+            assert(memcmp(out[0], objects[0], size) == 0 && memcmp(out[9], objects[9], size) == 0);
+            assert(memcmp(out[4], objects[4], size) == 0);
+            // extract_n packs them in tight
+            assert(memcmp(out[1], packed + size, 3 * size) == 0);
+            dyn_array_clear(dyn_a);
+        }
+        dyn_array_destroy(dyn_a);
+    }
+}
+
+void run_basic_tests_r() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[40];
+    for (int idx = 0; idx < 40; ++idx) {
+        numbers[idx] = (idx * 17) % 40;
+    }
+
+    // 1 create_with_allocator
+    counting_allocator_t counter = {0, 0, 0, 0, SIZE_MAX};
+    const dyn_allocator_t counting = {&counting_alloc, &counting_realloc, &counting_free, &counter};
+    assert((dyn_a = dyn_array_create_with_allocator(0, sizeof(int), NULL, &counting)));
+    assert(counter.allocs == 2);
+    assert(counter.outstanding == sizeof(dyn_array_t) + 16 * sizeof(int));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 40));
+    assert(counter.reallocs);
+    assert(counter.outstanding == sizeof(dyn_array_t) + dyn_array_capacity(dyn_a) * sizeof(int));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(counter.allocs == 3);
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) == idx);
+    }
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(counter.frees == 1);
+    assert(counter.outstanding == sizeof(dyn_array_t) + 40 * sizeof(int));
+    dyn_array_destroy(dyn_a);
+    assert(counter.outstanding == 0);
+    assert(counter.allocs == counter.frees);
+
+    // 2 create_with_allocator
+    bump_arena_t arena;
+    arena.used = 0;
+    const dyn_allocator_t bump = {&bump_alloc, NULL, NULL, &arena};
+    assert((dyn_a = dyn_array_create_with_allocator(0, sizeof(int), NULL, &bump)));
+    const size_t created_used = arena.used;
+    assert(created_used >= sizeof(dyn_array_t) + 16 * sizeof(int));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 20));
+    assert(arena.used == created_used + 32 * sizeof(int));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 20, 20));
+    assert(dyn_array_size(dyn_a) == 40);
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) == numbers[(idx + 20) % 40]);
+    }
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(*((int *) dyn_array_front(dyn_a)) == 0 && *((int *) dyn_array_back(dyn_a)) == 39);
+    const size_t before_destroy = arena.used;
+    dyn_array_destroy(dyn_a);
+    assert(arena.used == before_destroy);
+    // the arena's the only thing to reset
+    arena.used = 0;
+
+    // 3 create_with_allocator
+    assert((dyn_a = dyn_array_create_with_allocator(17, sizeof(int), NULL, NULL)));
+    assert(dyn_array_capacity(dyn_a) == 32);
+    assert(dyn_a->allocator.alloc == dyn_default_allocator.alloc);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 40));
+    dyn_array_destroy(dyn_a);
+
+    // 4 create_with_allocator
+    counter.budget = sizeof(dyn_array_t);
+    assert(dyn_array_create_with_allocator(0, sizeof(int), NULL, &counting) == NULL);
+    assert(counter.outstanding == 0);
+    counter.budget = sizeof(dyn_array_t) + 16 * sizeof(int);
+    assert((dyn_a = dyn_array_create_with_allocator(0, sizeof(int), NULL, &counting)));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 16));
+    assert(dyn_array_push_back(dyn_a, numbers + 16) == false);
+    assert(dyn_array_sort_stable(dyn_a, &int_compare) == false);
+    assert(dyn_array_size(dyn_a) == 16);
+    counter.budget = SIZE_MAX - counter.outstanding;
+    assert(dyn_array_push_back(dyn_a, numbers + 16));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    dyn_array_destroy(dyn_a);
+    assert(counter.outstanding == 0);
+
+    // 5 create_with_allocator
+    const dyn_allocator_t broken = {NULL, &counting_realloc, &counting_free, &counter};
+    assert(dyn_array_create_with_allocator(0, sizeof(int), NULL, &broken) == NULL);
+    assert(dyn_array_create_with_allocator(0, 0, NULL, &counting) == NULL);
+    assert(dyn_array_create_with_allocator(DYN_MAX_CAPACITY + 1, sizeof(int), NULL, &counting) == NULL);
+    assert(counter.outstanding == 0);
+}
+
+void run_basic_tests_s() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[40];
+    for (int idx = 0; idx < 40; ++idx) {
+        numbers[idx] = 39 - idx;
+    }
+    DYN_ARRAY_INLINE_BUFFER(buffer, 8, sizeof(int));
+    uint8_t *const storage = buffer.bytes + DYN_ARRAY_INLINE_OVERHEAD;
+
+    // 1 init_inline
+    assert((dyn_a = dyn_array_init_inline(&buffer, sizeof(buffer), sizeof(int), NULL)));
+    assert((void *) dyn_a == (void *) &buffer);
+    assert(dyn_array_capacity(dyn_a) == 8);
+    assert(dyn_array_empty(dyn_a));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 8));
+    assert(dyn_array_capacity(dyn_a) == 8);
+    assert(dyn_array_front(dyn_a) == storage);
+    assert(*((int *) dyn_array_back(dyn_a)) == 32);
+
+    // 2 init_inline
+    assert(dyn_array_push_back(dyn_a, numbers + 8));
+    assert(dyn_array_capacity(dyn_a) == 16);
+    assert((uint8_t *) dyn_array_front(dyn_a) != storage);
+    for (int idx = 0; idx < 9; ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) == 39 - idx);
+    }
+
+    // 3 init_inline
+    assert(dyn_array_pop_back_n(dyn_a, 4));
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_array_capacity(dyn_a) == 8);
+    assert(dyn_array_front(dyn_a) == storage);
+    for (int idx = 0; idx < 5; ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) == 39 - idx);
+    }
+    // and a wrapped ring on the way back out
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 20, 3));
+    assert(dyn_a->head);
+    assert(dyn_array_push_front(dyn_a, numbers + 30));
+    assert(dyn_array_size(dyn_a) == 9 && dyn_array_capacity(dyn_a) == 16);
+    assert(*((int *) dyn_array_at(dyn_a, 0)) == 9);
+    assert(*((int *) dyn_array_at(dyn_a, 1)) == 19);
+    assert(*((int *) dyn_array_at(dyn_a, 3)) == 17);
+    for (int idx = 4; idx < 9; ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) == 43 - idx);
+    }
+
+    // 4 init_inline
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(*((int *) dyn_array_front(dyn_a)) == 9 && *((int *) dyn_array_back(dyn_a)) == 39);
+    assert(dyn_array_reserve(dyn_a, 40));
+    assert(dyn_array_capacity(dyn_a) == 40);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 31));
+    assert(dyn_array_capacity(dyn_a) == 40);
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(dyn_array_front(dyn_a) == NULL && dyn_a->array == storage);
+    assert(dyn_array_push_back_n(dyn_a, numbers, 2));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(*((int *) dyn_array_front(dyn_a)) == 38);
+    dyn_array_destroy(dyn_a);
+
+    // 5 init_inline
+    DYN_ARRAY_INLINE_BUFFER(block_buffer, 2, DATA_BLOCK_SIZE);
+    assert((dyn_a = dyn_array_init_inline(&block_buffer, sizeof(block_buffer), DATA_BLOCK_SIZE, &block_destructor)));
+    assert(dyn_array_capacity(dyn_a) == 2);
+    destruct_counter = 0;
+    assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[0]));
+    assert(dyn_array_pop_back(dyn_a));
+    assert(destruct_counter == 1);
+    assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[0]));
+    assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[1]));
+    assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[2]));
+    assert(memcmp(dyn_array_at(dyn_a, 2), DATA_BLOCKS[2], DATA_BLOCK_SIZE) == 0);
+    dyn_array_destroy(dyn_a);
+    assert(destruct_counter == 4);
+    destruct_counter = 0;
+    // still ours, and still fine to use
+    memset(&block_buffer, 0x00, sizeof(block_buffer));
+
+    // 6 init_inline
+    assert(dyn_array_init_inline(NULL, sizeof(buffer), sizeof(int), NULL) == NULL);
+    assert(dyn_array_init_inline(&buffer, DYN_ARRAY_INLINE_SIZE(1, sizeof(int)) - 1, sizeof(int), NULL) == NULL);
+    assert(dyn_array_init_inline(&buffer, DYN_ARRAY_INLINE_OVERHEAD / 2, sizeof(int), NULL) == NULL);
+    assert(dyn_array_init_inline(buffer.bytes + 1, sizeof(buffer) - 1, sizeof(int), NULL) == NULL);
+    assert(dyn_array_init_inline(&buffer, sizeof(buffer), 0, NULL) == NULL);
+    assert((dyn_a = dyn_array_init_inline(&buffer, DYN_ARRAY_INLINE_SIZE(1, sizeof(int)), sizeof(int), NULL)));
+    assert(dyn_array_capacity(dyn_a) == 1);
+    dyn_array_destroy(dyn_a);
+}
+
+void run_basic_tests_t() {
+    dyn_segmented_t *seg_a = NULL;
+    int numbers[64], collected[64], *out = collected;
+    int *pointers[64];
+    for (int idx = 0; idx < 64; ++idx) {
+        numbers[idx] = idx;
+    }
+
+    // 1 segmented
+    assert((seg_a = dyn_segmented_create(sizeof(int), NULL)));
+    assert(dyn_segmented_empty(seg_a));
+    assert(dyn_segmented_capacity(seg_a) == 16);
+    assert(dyn_segmented_data_size(seg_a) == sizeof(int));
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(dyn_segmented_push_back(seg_a, numbers + idx));
+        pointers[idx] = (int *) dyn_segmented_back(seg_a);
+    }
+    assert(dyn_segmented_size(seg_a) == 40);
+    assert(dyn_segmented_capacity(seg_a) == 48);
+    assert(*((int *) dyn_segmented_front(seg_a)) == 0 && *pointers[39] == 39);
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(dyn_segmented_at(seg_a, idx) == pointers[idx]);
+        assert(*pointers[idx] == idx);
+    }
+    // segment boundaries
+    assert(pointers[15] + 1 != pointers[16]);
+    assert(pointers[16] + 23 == pointers[39]);
+
+    // 2 segmented
+    assert(dyn_segmented_push_back_n(seg_a, numbers + 40, 24));
+    assert(dyn_segmented_size(seg_a) == 64 && dyn_segmented_capacity(seg_a) == 112);
+    for (int idx = 0; idx < 64; ++idx) {
+        assert(*((int *) dyn_segmented_at(seg_a, idx)) == idx);
+    }
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(dyn_segmented_at(seg_a, idx) == pointers[idx]);
+    }
+
+    // 3 segmented
+    span_count = 0;
+    assert(dyn_segmented_for_each_span(seg_a, &int_span_collect, &out, 0));
+    assert(span_count == 3);
+    assert(span_sizes[0] == 16 && span_sizes[1] == 32 && span_sizes[2] == 16);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+    span_count = 0;
+    out = collected;
+    assert(dyn_segmented_for_each_span(seg_a, &int_span_collect, &out, 20));
+    assert(span_count == 4);
+    assert(span_sizes[0] == 16 && span_sizes[1] == 20 && span_sizes[2] == 12 && span_sizes[3] == 16);
+    assert(memcmp(collected, numbers, sizeof(numbers)) == 0);
+    const int increment = 100;
+    assert(dyn_segmented_for_each(seg_a, &int_add_arg, (void *) &increment));
+    for (int idx = 0; idx < 64; ++idx) {
+        assert(*((int *) dyn_segmented_at(seg_a, idx)) == idx + 100);
+    }
+
+    // 7 segmented
+    assert(dyn_segmented_push_back(seg_a, numbers) == false);
+    assert(dyn_segmented_push_back_n(seg_a, numbers, 1) == false);
+    assert(dyn_segmented_at(seg_a, 64) == NULL);
+    assert(dyn_segmented_reserve(seg_a, DYN_MAX_CAPACITY + 1) == false);
+
+    // 5 segmented
+    int extracted = 0;
+    assert(dyn_segmented_extract_back(seg_a, &extracted));
+    assert(extracted == 163);
+    for (int idx = 0; idx < 46; ++idx) {
+        assert(dyn_segmented_pop_back(seg_a));
+    }
+    assert(dyn_segmented_size(seg_a) == 17 && dyn_segmented_capacity(seg_a) == 112);
+    assert(dyn_segmented_shrink_to_fit(seg_a));
+    assert(dyn_segmented_capacity(seg_a) == 48);
+    assert(dyn_segmented_at(seg_a, 16) == pointers[16]);
+    dyn_segmented_clear(seg_a);
+    assert(dyn_segmented_shrink_to_fit(seg_a));
+    assert(dyn_segmented_capacity(seg_a) == 16);
+    assert(dyn_segmented_reserve(seg_a, 17));
+    assert(dyn_segmented_capacity(seg_a) == 48);
+    assert(dyn_segmented_pop_back(seg_a) == false);
+    assert(dyn_segmented_front(seg_a) == NULL && dyn_segmented_back(seg_a) == NULL);
+    dyn_segmented_destroy(seg_a);
+
+    // 4 segmented
+    assert((seg_a = dyn_segmented_create(DATA_BLOCK_SIZE, &block_destructor)));
+    destruct_counter = 0;
+    for (int idx = 0; idx < 20; ++idx) {
+        assert(dyn_segmented_push_back(seg_a, DATA_BLOCKS[idx % 5]));
+    }
+    uint8_t block[DATA_BLOCK_SIZE];
+    assert(dyn_segmented_extract_back(seg_a, block));
+    assert(memcmp(block, DATA_BLOCKS[4], DATA_BLOCK_SIZE) == 0);
+    assert(destruct_counter == 0);
+    assert(dyn_segmented_pop_back(seg_a));
+    assert(destruct_counter == 1);
+    assert(memcmp(dyn_segmented_back(seg_a), DATA_BLOCKS[2], DATA_BLOCK_SIZE) == 0);
+    dyn_segmented_clear(seg_a);
+    assert(destruct_counter == 19);
+    assert(dyn_segmented_push_back_n(seg_a, DATA_BLOCKS, 5));
+    dyn_segmented_destroy(seg_a);
+    assert(destruct_counter == 24);
+    destruct_counter = 0;
+
+    // 6 segmented
+    assert(DYN_SEGMENT_OF(0) == 0 && DYN_SEGMENT_OF(15) == 0);
+    assert(DYN_SEGMENT_OF(16) == 1 && DYN_SEGMENT_OF(47) == 1 && DYN_SEGMENT_OF(48) == 2);
+    for (size_t segment = 1; segment < DYN_SEGMENT_SLOTS - DYN_SEGMENT_SHIFT; ++segment) {
+        assert(DYN_SEGMENT_OF(DYN_SEGMENTS_CAPACITY(segment)) == segment);
+        assert(DYN_SEGMENT_OF(DYN_SEGMENTS_CAPACITY(segment) - 1) == segment - 1);
+    }
+    assert(DYN_SEGMENT_OF(SIZE_MAX - DYN_MIN_CAPACITY) == DYN_SEGMENT_SLOTS - DYN_SEGMENT_SHIFT - 1);
+
+    // 7 segmented
+    assert(dyn_segmented_create(0, NULL) == NULL);
+    assert(dyn_segmented_push_back(NULL, numbers) == false);
+    assert((seg_a = dyn_segmented_create(sizeof(int), NULL)));
+    assert(dyn_segmented_push_back(seg_a, NULL) == false);
+    assert(dyn_segmented_push_back_n(seg_a, NULL, 1) == false);
+    assert(dyn_segmented_push_back_n(seg_a, numbers, 0) == false);
+    assert(dyn_segmented_extract_back(seg_a, &extracted) == false);
+    assert(dyn_segmented_push_back(seg_a, numbers));
+    assert(dyn_segmented_extract_back(seg_a, NULL) == false);
+    assert(dyn_segmented_for_each(seg_a, NULL, NULL) == false);
+    assert(dyn_segmented_for_each_span(seg_a, NULL, NULL, 0) == false);
+    assert(dyn_segmented_at(NULL, 0) == NULL && dyn_segmented_back(NULL) == NULL);
+    assert(dyn_segmented_pop_back(NULL) == false && dyn_segmented_extract_back(NULL, &extracted) == false);
+    assert(dyn_segmented_empty(NULL) && dyn_segmented_size(NULL) == 0 && dyn_segmented_capacity(NULL) == 0);
+    assert(dyn_segmented_data_size(NULL) == 0);
+    assert(dyn_segmented_reserve(NULL, 1) == false && dyn_segmented_shrink_to_fit(NULL) == false);
+    assert(dyn_segmented_for_each(NULL, &int_add_arg, NULL) == false);
+    assert(dyn_segmented_for_each_span(NULL, &int_span_collect, NULL, 0) == false);
+    dyn_segmented_clear(NULL);
+    dyn_segmented_destroy(NULL);
+    dyn_segmented_destroy(seg_a);
+}
+
+void run_basic_tests_u() {
+    const dyn_allocator_t *const allocator = &dyn_default_allocator;
+    const size_t small = DYN_MMAP_THRESHOLD / 2, big = DYN_MMAP_THRESHOLD * 4;
+
+    // 1 default allocator
+    uint8_t *block = NULL;
+    assert((block = (uint8_t *) dyn_alloc(allocator, big)));
+#ifdef DYN_USE_MMAP
+    // mmap'd, so page aligned (whatever the page size is, it has nothing to do with the threshold)
+    assert((uintptr_t) block % (uintptr_t) sysconf(_SC_PAGESIZE) == 0);
+#endif
+    for (size_t idx = 0; idx < big; ++idx) {
+        block[idx] = (uint8_t) (idx * 7);
+    }
+
+    // 2 default allocator
+    assert((block = (uint8_t *) dyn_realloc(allocator, block, big, big * 8)));
+    memset(block + big, 0x5A, big * 7);
+    assert((block = (uint8_t *) dyn_realloc(allocator, block, big * 8, big + 1)));
+    for (size_t idx = 0; idx < big; ++idx) {
+        assert(block[idx] == (uint8_t) (idx * 7));
+    }
+    assert(block[big] == 0x5A);
+
+    // 3 default allocator
+    assert((block = (uint8_t *) dyn_realloc(allocator, block, big + 1, small)));
+    for (size_t idx = 0; idx < small; ++idx) {
+        assert(block[idx] == (uint8_t) (idx * 7));
+    }
+    assert((block = (uint8_t *) dyn_realloc(allocator, block, small, big)));
+    for (size_t idx = 0; idx < small; ++idx) {
+        assert(block[idx] == (uint8_t) (idx * 7));
+    }
+    dyn_free(allocator, block, big);
+
+    // 4 default allocator
+    dyn_array_t *dyn_a = NULL;
+    assert((dyn_a = dyn_array_create(0, DATA_BLOCK_SIZE, NULL)));
+    assert(DYN_SIZE_N_ELEMS(dyn_a, dyn_a->capacity) < DYN_MMAP_THRESHOLD);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (size_t idx = 0; idx < 40; ++idx) {
+        assert(dyn_array_push_front(dyn_a, DATA_BLOCKS[idx % 5]));
+    }
+    assert(DYN_SIZE_N_ELEMS(dyn_a, dyn_a->capacity) >= DYN_MMAP_THRESHOLD);
+    assert(dyn_a->head);
+    assert(dyn_array_push_back_n(dyn_a, DATA_BLOCKS, 5));
+    assert(dyn_array_size(dyn_a) == 45 && dyn_array_capacity(dyn_a) == 64);
+    for (size_t idx = 0; idx < 40; ++idx) {
+        assert(memcmp(dyn_array_at(dyn_a, idx), DATA_BLOCKS[(39 - idx) % 5], DATA_BLOCK_SIZE) == 0);
+    }
+    for (size_t idx = 40; idx < 45; ++idx) {
+        assert(memcmp(dyn_array_at(dyn_a, idx), DATA_BLOCKS[idx - 40], DATA_BLOCK_SIZE) == 0);
+    }
+    assert(dyn_array_pop_front_n(dyn_a, 41));
+    assert(dyn_array_shrink_to_fit(dyn_a));
+    assert(DYN_SIZE_N_ELEMS(dyn_a, dyn_a->capacity) < DYN_MMAP_THRESHOLD);
+    for (size_t idx = 0; idx < 4; ++idx) {
+        assert(memcmp(dyn_array_at(dyn_a, idx), DATA_BLOCKS[idx + 1], DATA_BLOCK_SIZE) == 0);
+    }
+    dyn_array_destroy(dyn_a);
+}
+
+// Writes bytes to path, for making broken files
+void write_test_file(const char *const path, const void *const bytes, const size_t count) {
+    FILE *file = fopen(path, "wb");
+    assert(file);
+    assert(fwrite(bytes, 1, count, file) == count);
+    assert(fclose(file) == 0);
+}
+
+void run_basic_tests_v() {
+    const char *const path = "dyn_array_test_map.bin";
+    dyn_array_t *dyn_a = NULL, *dyn_b = NULL;
+    int numbers[40];
+    for (int idx = 0; idx < 40; ++idx) {
+        numbers[idx] = idx * 3;
+    }
+
+    // 1 save, map
+    assert((dyn_a = dyn_array_import(numbers, 40, sizeof(int), NULL)));
+    assert(dyn_array_save(dyn_a, path));
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_READ_ONLY)));
+    assert(dyn_array_size(dyn_b) == 40 && dyn_array_data_size(dyn_b) == sizeof(int));
+    assert(memcmp(dyn_array_export(dyn_b), numbers, sizeof(numbers)) == 0);
+    assert(((uintptr_t) dyn_array_front(dyn_b) & (DYN_CACHE_LINE - 1)) == 0);
+    assert(dyn_array_bsearch(dyn_b, numbers + 17, &int_compare) == dyn_array_at(dyn_b, 17));
+    assert(dyn_array_push_back(dyn_b, numbers) == false);
+    assert(dyn_array_pop_back(dyn_b) == false);
+    assert(dyn_array_erase(dyn_b, 3) == false);
+    assert(dyn_array_sort(dyn_b, &int_compare) == false);
+    assert(dyn_array_sort_stable(dyn_b, &int_compare) == false);
+    assert(dyn_array_sort_radix(dyn_b, 0, sizeof(int), DYN_RADIX_SIGNED) == false);
+    assert(dyn_array_reserve(dyn_b, 64) == false);
+    // already a perfect fit, nothing to do
+    assert(dyn_array_shrink_to_fit(dyn_b));
+    dyn_array_clear(dyn_b);
+    assert(dyn_array_size(dyn_b) == 40);
+    dyn_array_destroy(dyn_b);
+
+    // 2 save, map
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_PRIVATE)));
+    *((int *) dyn_array_at(dyn_b, 0)) = -1;
+    assert(dyn_array_erase(dyn_b, 1));
+    assert(*((int *) dyn_array_at(dyn_b, 1)) == 6);
+    assert(dyn_array_pop_back(dyn_b));
+    assert(dyn_array_sort(dyn_b, &int_compare));
+    assert(DYN_FLAG_CHECK(dyn_b, MAPPED));
+    // full again, so this one has to move out
+    assert(dyn_array_push_back_n(dyn_b, numbers, 3));
+    assert(!DYN_FLAG_CHECK(dyn_b, MAPPED));
+    assert(dyn_array_size(dyn_b) == 41);
+    assert(*((int *) dyn_array_at(dyn_b, 0)) == -1 && *((int *) dyn_array_at(dyn_b, 37)) == 114);
+    assert(*((int *) dyn_array_at(dyn_b, 38)) == 0 && *((int *) dyn_array_back(dyn_b)) == 6);
+    dyn_array_destroy(dyn_b);
+    // the file didn't see any of that
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_PRIVATE)));
+    assert(memcmp(dyn_array_export(dyn_b), numbers, sizeof(numbers)) == 0);
+    assert(dyn_array_shrink_to_fit(dyn_b));
+    assert(memcmp(dyn_array_export(dyn_b), numbers, sizeof(numbers)) == 0);
+    dyn_array_destroy(dyn_b);
+
+    // 3 save, map
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_push_back_n(dyn_a, numbers + 20, 20));
+    assert(dyn_array_push_front_n(dyn_a, numbers, 20));
+    assert(dyn_a->head);
+    assert(dyn_array_save(dyn_a, path));
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_READ_ONLY)));
+    assert(memcmp(dyn_array_export(dyn_b), numbers, sizeof(numbers)) == 0);
+    dyn_array_destroy(dyn_b);
+
+    // 4 save, map
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_save(dyn_a, path));
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_READ_ONLY)));
+    assert(dyn_array_empty(dyn_b) && dyn_array_data_size(dyn_b) == sizeof(int));
+    assert(dyn_array_push_back(dyn_b, numbers) == false);
+    assert(dyn_array_insert_n(dyn_b, 0, numbers, 2) == false);
+    assert(dyn_array_empty(dyn_b));
+    dyn_array_destroy(dyn_b);
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_PRIVATE)));
+    assert(dyn_array_empty(dyn_b));
+    assert(dyn_array_push_back(dyn_b, numbers));
+    dyn_array_destroy(dyn_b);
+
+    // 5 save, map
+    uint8_t file[DYN_FILE_HEADER_SIZE + sizeof(numbers)];
+    assert(dyn_array_push_back_n(dyn_a, numbers, 40));
+    assert(dyn_array_save(dyn_a, path));
+    FILE *saved = fopen(path, "rb");
+    assert(saved && fread(file, 1, sizeof(file), saved) == sizeof(file));
+    fclose(saved);
+    dyn_file_header_t *const header = (dyn_file_header_t *) file;
+    assert(header->count == 40 && header->data_size == sizeof(int) && header->version == DYN_FILE_VERSION);
+    write_test_file(path, file, sizeof(file) - 1);
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    write_test_file(path, file, DYN_FILE_HEADER_SIZE / 2);
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    header->magic[0] = 'X';
+    write_test_file(path, file, sizeof(file));
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    header->magic[0] = 'D';
+    header->version = DYN_FILE_VERSION + 1;
+    write_test_file(path, file, sizeof(file));
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    header->version = DYN_FILE_VERSION;
+    header->data_size = 0;
+    write_test_file(path, file, sizeof(file));
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    header->data_size = sizeof(int);
+    header->count = DYN_MAX_CAPACITY + 1;
+    write_test_file(path, file, sizeof(file));
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+    header->count = 40;
+    write_test_file(path, file, sizeof(file));
+    assert(dyn_array_map(path, (DYN_MAP_FLAGS) 0x02) == NULL);
+    assert((dyn_b = dyn_array_map(path, DYN_MAP_READ_ONLY)));
+    dyn_array_destroy(dyn_b);
+    assert(remove(path) == 0);
+    assert(dyn_array_map(path, DYN_MAP_READ_ONLY) == NULL);
+
+    // 6 save, map
+    assert(dyn_array_save(NULL, path) == false);
+    assert(dyn_array_save(dyn_a, NULL) == false);
+    assert(dyn_array_save(dyn_a, "no/such/directory/dyn_array.bin") == false);
+    assert(dyn_array_map(NULL, DYN_MAP_READ_ONLY) == NULL);
+    dyn_array_destroy(dyn_a);
+}
+
+int int_compare_inv(const void *const a, const void *const b) {
+    return int_compare(b, a);
+}
+
+// Every parent >= each of its children
+bool int_is_heap(const dyn_array_t *const dyn_array, const size_t arity, int (*compare)(const void *, const void *)) {
+    for (size_t child = 1; child < dyn_array_size(dyn_array); ++child) {
+        if (compare(dyn_array_at(dyn_array, (child - 1) / arity), dyn_array_at(dyn_array, child)) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void run_basic_tests_w() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[60], out = 0;
+    for (int idx = 0; idx < 60; ++idx) {
+        numbers[idx] = (idx * 37) % 50;
+    }
+
+    // 1 heap
+    const size_t arities[3] = {2, 3, 4};
+    for (size_t arity_idx = 0; arity_idx < 3; ++arity_idx) {
+        const size_t arity = arities[arity_idx];
+        assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+        assert(dyn_array_set_heap_arity(dyn_a, arity));
+        for (int idx = 0; idx < 60; ++idx) {
+            assert(dyn_array_heap_push(dyn_a, numbers + idx, &int_compare));
+            assert(int_is_heap(dyn_a, arity, &int_compare));
+        }
+        assert(*((int *) dyn_array_heap_top(dyn_a)) == 49);
+        int last = 50;
+        for (int idx = 0; idx < 60; ++idx) {
+            assert(dyn_array_heap_extract(dyn_a, &out, &int_compare));
+            assert(out <= last);
+            last = out;
+            assert(int_is_heap(dyn_a, arity, &int_compare));
+        }
+        assert(last == 0 && dyn_array_empty(dyn_a));
+
+        // 2 heap
+        assert(dyn_array_push_back_n(dyn_a, numbers, 60));
+        assert(dyn_array_heapify(dyn_a, &int_compare));
+        assert(int_is_heap(dyn_a, arity, &int_compare));
+        assert(dyn_array_size(dyn_a) == 60);
+
+        // 3 heap
+        for (size_t idx = 0; idx < 60; idx += 7) {
+            *((int *) dyn_array_at(dyn_a, idx)) += (idx & 1) ? 100 : -100;
+            assert(dyn_array_heap_update(dyn_a, idx, &int_compare));
+            assert(int_is_heap(dyn_a, arity, &int_compare));
+        }
+        assert(*((int *) dyn_array_heap_top(dyn_a)) >= 100);
+        dyn_array_destroy(dyn_a);
+    }
+
+    // 4 heap
+    assert((dyn_a = dyn_array_create(0, DATA_BLOCK_SIZE, &block_destructor)));
+    for (size_t idx = 0; idx < 5; ++idx) {
+        assert(dyn_array_heap_push(dyn_a, DATA_BLOCKS[idx], &block_compare));
+    }
+    destruct_counter = 0;
+    uint8_t block[DATA_BLOCK_SIZE];
+    assert(dyn_array_heap_extract(dyn_a, block, &block_compare));
+    assert(memcmp(block, DATA_BLOCKS[4], DATA_BLOCK_SIZE) == 0);
+    assert(destruct_counter == 0);
+    assert(dyn_array_heap_pop(dyn_a, &block_compare));
+    assert(destruct_counter == 1);
+    assert(memcmp(dyn_array_heap_top(dyn_a), DATA_BLOCKS[2], DATA_BLOCK_SIZE) == 0);
+    destruct_counter = 0;
+    dyn_array_destroy(dyn_a);
+    destruct_counter = 0;
+
+    // 5 heap
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    assert(dyn_array_set_heap_arity(dyn_a, 4));
+    assert(dyn_array_push_back_n(dyn_a, numbers, 10));
+    assert(dyn_array_push_front_n(dyn_a, numbers + 10, 10));
+    assert(dyn_a->head);
+    assert(dyn_array_heapify(dyn_a, &int_compare_inv));
+    for (int idx = 20; idx < 60; ++idx) {
+        assert(dyn_array_heap_push(dyn_a, numbers + idx, &int_compare_inv));
+    }
+    assert(int_is_heap(dyn_a, 4, &int_compare_inv));
+    for (int idx = 0, last = -1; idx < 60; ++idx) {
+        assert(*((int *) dyn_array_heap_top(dyn_a)) >= last);
+        last = *((int *) dyn_array_heap_top(dyn_a));
+        assert(dyn_array_heap_pop(dyn_a, &int_compare_inv));
+    }
+
+    // 6 heap
+    assert(dyn_array_heap_pop(dyn_a, &int_compare) == false);
+    assert(dyn_array_heap_extract(dyn_a, &out, &int_compare) == false);
+    assert(dyn_array_heap_top(dyn_a) == NULL);
+    assert(dyn_array_heapify(dyn_a, &int_compare));
+    assert(dyn_array_heap_push(dyn_a, numbers, &int_compare));
+    assert(dyn_array_heap_update(dyn_a, 1, &int_compare) == false);
+    assert(dyn_array_heap_update(dyn_a, 0, NULL) == false);
+    assert(dyn_array_heap_push(dyn_a, NULL, &int_compare) == false);
+    assert(dyn_array_heap_push(dyn_a, numbers, NULL) == false);
+    assert(dyn_array_heap_pop(dyn_a, NULL) == false);
+    assert(dyn_array_heap_extract(dyn_a, NULL, &int_compare) == false);
+    assert(dyn_array_heapify(dyn_a, NULL) == false);
+    assert(dyn_array_set_heap_arity(dyn_a, 1) == false);
+    assert(dyn_array_set_heap_arity(dyn_a, 17) == false);
+    assert(dyn_array_set_heap_arity(NULL, 2) == false);
+    assert(dyn_array_heapify(NULL, &int_compare) == false);
+    assert(dyn_array_heap_push(NULL, numbers, &int_compare) == false);
+    assert(dyn_array_heap_pop(NULL, &int_compare) == false);
+    assert(dyn_array_heap_top(NULL) == NULL);
+    DYN_FLAG_SET(dyn_a, READ_ONLY);
+    assert(dyn_array_heap_push(dyn_a, numbers, &int_compare) == false);
+    assert(dyn_array_heap_pop(dyn_a, &int_compare) == false);
+    assert(dyn_array_heapify(dyn_a, &int_compare) == false);
+    assert(dyn_array_heap_update(dyn_a, 0, &int_compare) == false);
+    DYN_FLAG_UNSET(dyn_a, READ_ONLY);
+    dyn_array_destroy(dyn_a);
+}
+
+bool int_is_odd(const void *const object, void *arg) {
+    (void) arg;
+    return *((const int *) object) % 2;
+}
+
+void int_negate(void *const object, void *arg) {
+    (void) arg;
+    *((int *) object) = -*((int *) object);
+}
+
+void int_negate_span(void *const objects, const size_t count, void *arg) {
+    for (size_t idx = 0; idx < count; ++idx) {
+        int_negate((int *) objects + idx, arg);
+    }
+}
+
+void run_basic_tests_x() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[40], out = 0, probe = 0;
+    for (int idx = 0; idx < 40; ++idx) {
+        numbers[idx] = (idx * 17) % 20;
+    }
+
+    // 1 sorted
+    assert((dyn_a = dyn_array_import(numbers, 40, sizeof(int), NULL)));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_pop_back(dyn_a) && dyn_array_pop_front(dyn_a));
+    assert(dyn_array_erase(dyn_a, 10) && dyn_array_erase_n(dyn_a, 0, 3));
+    assert(dyn_array_extract(dyn_a, 5, &out));
+    assert(dyn_array_prune(dyn_a, &int_is_odd, NULL));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    for (size_t idx = 0; idx < dyn_array_size(dyn_a); ++idx) {
+        assert(*((int *) dyn_array_at(dyn_a, idx)) % 2 == 0);
+    }
+    assert(dyn_scan_sorted(dyn_a, &int_compare));
+    dyn_array_clear(dyn_a);
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    dyn_array_destroy(dyn_a);
+
+    assert((dyn_a = dyn_array_import(numbers, 40, sizeof(int), NULL)));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_sort_stable(dyn_a, &int_compare_inv));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare_inv));
+    assert(*((int *) dyn_array_front(dyn_a)) == 19);
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 4));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_sort_parallel(dyn_a, &int_compare, 4));
+    assert(*((int *) dyn_array_front(dyn_a)) == 0 && *((int *) dyn_array_back(dyn_a)) == 19);
+    dyn_array_destroy(dyn_a);
+
+    // 2 sorted
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_sort(dyn_a, &int_compare) == false);
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    for (int idx = 0; idx < 10; ++idx) {
+        probe = idx * 2;
+        assert(dyn_array_push_back(dyn_a, &probe));
+    }
+    probe = 18;
+    assert(dyn_array_push_back(dyn_a, &probe));
+    probe = 0;
+    assert(dyn_array_push_front(dyn_a, &probe));
+    probe = 7;
+    assert(dyn_array_insert(dyn_a, 5, &probe));
+    assert(dyn_array_insert_sorted(dyn_a, numbers + 3, &int_compare));
+    assert(dyn_array_insert_sorted_stable(dyn_a, numbers + 4, &int_compare));
+    assert(dyn_array_push_back_n(dyn_a, (int[]) {20, 20, 21}, 3));
+    assert(dyn_array_insert_n(dyn_a, 1, (int[]) {0, 0}, 2));
+    assert(dyn_array_append_range(dyn_a, dyn_a, dyn_array_size(dyn_a) - 1, 1));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_size(dyn_a) == 21);
+    // self-append, out of order
+    assert(dyn_array_append_range(dyn_a, dyn_a, 0, 2));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare) == false);
+    assert(dyn_array_pop_back_n(dyn_a, 2));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    // run out of order internally
+    assert(dyn_array_push_back_n(dyn_a, (int[]) {30, 29}, 2));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_pop_back_n(dyn_a, 2));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    probe = 5;
+    assert(dyn_array_push_back(dyn_a, &probe));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_pop_back(dyn_a));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    probe = 100;
+    assert(dyn_array_push_front(dyn_a, &probe));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_pop_front(dyn_a));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    // in order by some other comparator is out of order by ours
+    assert(dyn_array_insert_sorted(dyn_a, numbers + 5, &int_compare_inv));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    dyn_array_destroy(dyn_a);
+
+    // 3 sorted
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (int idx = 39; idx >= 0; --idx) {
+        assert(dyn_array_push_front(dyn_a, numbers + idx));
+    }
+    assert(dyn_a->head);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (probe = -1; probe <= 20; ++probe) {
+            const size_t found = dyn_array_find(dyn_a, &probe, &int_compare);
+            if (probe < 0 || probe == 20) {
+                assert(found == SIZE_MAX);
+                assert(dyn_array_contains(dyn_a, &probe, &int_compare) == false);
+            } else {
+                assert(found < dyn_array_size(dyn_a));
+                assert(*((int *) dyn_array_at(dyn_a, found)) == probe);
+                // first of the two
+                for (size_t idx = 0; idx < found; ++idx) {
+                    assert(*((int *) dyn_array_at(dyn_a, idx)) != probe);
+                }
+                assert(dyn_array_contains(dyn_a, &probe, &int_compare));
+            }
+        }
+        assert(dyn_array_sort(dyn_a, &int_compare));
+        assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    }
+    probe = 7;
+    assert(dyn_array_find(dyn_a, &probe, &int_compare) == 14);
+    dyn_array_destroy(dyn_a);
+
+    // 4 sorted
+    assert((dyn_a = dyn_array_import(numbers, 40, sizeof(int), NULL)));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare) == false);
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    dyn_a->flags &= ~SORTED;
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare_inv) == false);
+    // changed behind its back, sorting again notices
+    *((int *) dyn_array_front(dyn_a)) = 50;
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(*((int *) dyn_array_back(dyn_a)) == 50);
+    *((int *) dyn_array_front(dyn_a)) = 60;
+    assert(dyn_array_sort_stable(dyn_a, &int_compare));
+    assert(*((int *) dyn_array_back(dyn_a)) == 60);
+    dyn_a->flags &= ~SORTED;
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+
+    // 5 sorted
+    assert(dyn_array_heapify(dyn_a, &int_compare));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_heap_push(dyn_a, numbers, &int_compare));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_heap_pop(dyn_a, &int_compare));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_heap_extract(dyn_a, &out, &int_compare));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_heap_update(dyn_a, 0, &int_compare));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_sort_radix(dyn_a, 0, sizeof(int), DYN_RADIX_SIGNED));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+
+    // 6 sorted
+    probe = 3;
+    assert(dyn_array_is_sorted(NULL, &int_compare) == false);
+    assert(dyn_array_is_sorted(dyn_a, NULL) == false);
+    assert(dyn_array_find(NULL, &probe, &int_compare) == SIZE_MAX);
+    assert(dyn_array_find(dyn_a, NULL, &int_compare) == SIZE_MAX);
+    assert(dyn_array_find(dyn_a, &probe, NULL) == SIZE_MAX);
+    assert(dyn_array_contains(NULL, &probe, &int_compare) == false);
+    assert(dyn_array_contains(dyn_a, NULL, &int_compare) == false);
+    assert(dyn_array_contains(dyn_a, &probe, NULL) == false);
+    probe = 42;
+    assert(dyn_array_find(dyn_a, &probe, &int_compare) == SIZE_MAX);
+    dyn_array_destroy(dyn_a);
+
+    // 7 sorted
+    int top[3];
+    for (int variant = 0; variant < 3; ++variant) {
+        assert((dyn_a = dyn_array_import(numbers, 40, sizeof(int), NULL)));
+        assert(dyn_array_sort(dyn_a, &int_compare));
+        assert(DYN_IS_SORTED(dyn_a, &int_compare));
+        // 0 0 1 1 ... 19 19  ->  0 0 -1 -1 ... -19 -19
+        if (variant == 0) {
+            assert(dyn_array_for_each(dyn_a, &int_negate, NULL));
+        } else if (variant == 1) {
+            assert(dyn_array_for_each_span(dyn_a, &int_negate_span, NULL, 7));
+        } else {
+            assert(dyn_array_for_each_parallel(dyn_a, &int_negate, NULL, 4, 0));
+        }
+        assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+        probe = -3;
+        assert(dyn_array_find(dyn_a, &probe, &int_compare) == 6);
+        assert(dyn_array_contains(dyn_a, &probe, &int_compare));
+        assert(dyn_array_top_k(dyn_a, 3, top, &int_compare) == 3);
+        assert(top[0] == 0 && top[1] == 0 && top[2] == -1);
+        assert(dyn_array_nth_element(dyn_a, 0, &int_compare));
+        assert(*((int *) dyn_array_front(dyn_a)) == -19);
+        dyn_array_destroy(dyn_a);
+    }
+}
+
+// key and where it came from, to tell equal keys apart
+typedef struct {
+    int key;
+    int tag;
+} tagged_int_t;
+
+int tagged_compare(const void *const a, const void *const b) {
+    return ((const tagged_int_t *) a)->key - ((const tagged_int_t *) b)->key;
+}
+
+size_t int_count_of(const int *const values, const size_t count, const int value) {
+    size_t found = 0;
+    for (size_t idx = 0; idx < count; ++idx) {
+        found += values[idx] == value;
+    }
+    return found;
+}
+
+void run_basic_tests_y() {
+    dyn_array_t *dyn_a = NULL, *dyn_b = NULL, *dyn_c = NULL;
+    int runs[30], out = 0;
+    // runs of 1 to 4 of each of 0..10
+    for (int idx = 0; idx < 30; ++idx) {
+        runs[idx] = idx / 3 + (idx % 7 == 0);
+    }
+    qsort(runs, 30, sizeof(int), &int_compare);
+
+    // 1 unique
+    for (int flagged = 0; flagged < 2; ++flagged) {
+        assert((dyn_a = dyn_array_import(runs, 30, sizeof(int), NULL)));
+        if (flagged) {
+            assert(dyn_array_is_sorted(dyn_a, &int_compare));
+        }
+        assert(dyn_array_unique(dyn_a, &int_compare) == 19);
+        assert(dyn_array_size(dyn_a) == 11);
+        for (int idx = 0; idx < 11; ++idx) {
+            assert(*((int *) dyn_array_at(dyn_a, idx)) == idx);
+        }
+        assert(dyn_array_unique(dyn_a, &int_compare) == 0);
+        assert(DYN_FLAG_CHECK(dyn_a, SORTED) == (flagged ? SORTED : 0));
+        dyn_array_destroy(dyn_a);
+    }
+    // 0 1 1 2 2 2 3 3 3 3 4 4 4 4 4, destructor hits everything but the first of each
+    assert((dyn_a = dyn_array_create(0, DATA_BLOCK_SIZE, &block_destructor)));
+    for (int value = 0; value < 5; ++value) {
+        for (int copy = 0; copy <= value; ++copy) {
+            assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[value]));
+        }
+    }
+    assert(dyn_array_sort(dyn_a, &block_compare));
+    destruct_counter = 0;
+    assert(dyn_array_unique(dyn_a, &block_compare) == 10);
+    assert(destruct_counter == 10);
+    for (int value = 0; value < 5; ++value) {
+        assert(memcmp(dyn_array_at(dyn_a, value), DATA_BLOCKS[value], DATA_BLOCK_SIZE) == 0);
+    }
+    dyn_array_destroy(dyn_a);
+    destruct_counter = 0;
+
+    // 2 unique
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_unique(dyn_a, &int_compare) == 0);
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (int idx = 29; idx >= 0; --idx) {
+        assert(dyn_array_push_front(dyn_a, runs + idx));
+    }
+    assert(dyn_array_pop_back(dyn_a) && dyn_array_pop_back(dyn_a));
+    out = 10;
+    assert(dyn_array_push_back(dyn_a, &out));
+    assert(dyn_a->head);
+    assert(dyn_array_unique(dyn_a, &int_compare) == 18);
+    assert(dyn_array_size(dyn_a) == 11 && *((int *) dyn_array_back(dyn_a)) == 10);
+    assert(dyn_array_unique(dyn_a, &int_compare) == 0);
+    dyn_array_clear(dyn_a);
+    out = 4;
+    for (int idx = 0; idx < 40; ++idx) {
+        assert(dyn_array_push_back(dyn_a, &out));
+    }
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_unique(dyn_a, &int_compare) == 39);
+    assert(dyn_array_size(dyn_a) == 1 && *((int *) dyn_array_front(dyn_a)) == 4);
+    dyn_array_destroy(dyn_a);
+
+    // 3 merge
+    tagged_int_t lefts[10], rights[8];
+    for (int idx = 0; idx < 10; ++idx) {
+        lefts[idx] = (tagged_int_t) {idx / 2 * 3, 0};
+    }
+    for (int idx = 0; idx < 8; ++idx) {
+        rights[idx] = (tagged_int_t) {idx * 2, 1};
+    }
+    assert((dyn_a = dyn_array_import(lefts, 10, sizeof(tagged_int_t), NULL)));
+    assert((dyn_b = dyn_array_import(rights, 8, sizeof(tagged_int_t), NULL)));
+    assert((dyn_c = dyn_array_create(0, sizeof(tagged_int_t), NULL)));
+    const tagged_int_t first = {-1, 2};
+    assert(dyn_array_push_back(dyn_c, &first));
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &tagged_compare));
+    assert(dyn_array_size(dyn_c) == 19);
+    assert(((tagged_int_t *) dyn_array_front(dyn_c))->tag == 2);
+    for (size_t idx = 2; idx < 19; ++idx) {
+        const tagged_int_t *const prev = (tagged_int_t *) dyn_array_at(dyn_c, idx - 1);
+        const tagged_int_t *const next = (tagged_int_t *) dyn_array_at(dyn_c, idx);
+        assert(prev->key < next->key || (prev->key == next->key && prev->tag <= next->tag));
+    }
+    dyn_array_destroy(dyn_a);
+    dyn_array_destroy(dyn_b);
+    dyn_array_destroy(dyn_c);
+
+    // 4 merge
+    // a: 0 0 1 1 2 2 ... with a few extras, b: every third number twice, some once
+    int as[24], bs[20];
+    for (int idx = 0; idx < 24; ++idx) {
+        as[idx] = idx / 2 + (idx % 5 == 4);
+    }
+    for (int idx = 0; idx < 20; ++idx) {
+        bs[idx] = (idx / 2) * 3 - (idx % 7 == 6);
+    }
+    qsort(as, 24, sizeof(int), &int_compare);
+    qsort(bs, 20, sizeof(int), &int_compare);
+    assert((dyn_a = dyn_array_import(as, 24, sizeof(int), NULL)));
+    assert((dyn_b = dyn_array_import(bs, 20, sizeof(int), NULL)));
+    for (int mode = 0; mode < 3; ++mode) {
+        assert((dyn_c = dyn_array_create(0, sizeof(int), NULL)));
+        if (mode == 0) {
+            assert(dyn_array_set_union(dyn_c, dyn_a, dyn_b, &int_compare));
+        } else if (mode == 1) {
+            assert(dyn_array_set_intersection(dyn_c, dyn_a, dyn_b, &int_compare));
+        } else {
+            assert(dyn_array_set_difference(dyn_c, dyn_a, dyn_b, &int_compare));
+        }
+        size_t total = 0;
+        for (int value = -2; value < 40; ++value) {
+            const size_t in_a = int_count_of(as, 24, value), in_b = int_count_of(bs, 20, value);
+            const size_t expected = mode == 0 ? (in_a > in_b ? in_a : in_b)
+                                  : mode == 1 ? (in_a < in_b ? in_a : in_b)
+                                              : (in_a > in_b ? in_a - in_b : 0);
+            assert(int_count_of((const int *) dyn_array_export(dyn_c), dyn_array_size(dyn_c), value) == expected);
+            total += expected;
+        }
+        assert(dyn_array_size(dyn_c) == total);
+        assert(dyn_scan_sorted(dyn_c, &int_compare));
+        dyn_array_destroy(dyn_c);
+    }
+
+    // 5 merge
+    assert((dyn_c = dyn_array_create(64, sizeof(int), NULL)));
+    const void *const reserved = dyn_c->array;
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &int_compare));
+    assert(dyn_c->array == reserved && dyn_array_size(dyn_c) == 44);
+    assert(dyn_scan_sorted(dyn_c, &int_compare));
+    // nobody knew they were sorted, so dst doesn't either
+    assert(!DYN_FLAG_CHECK(dyn_c, SORTED));
+    dyn_array_clear(dyn_c);
+    assert(dyn_array_is_sorted(dyn_a, &int_compare) && dyn_array_is_sorted(dyn_b, &int_compare));
+    assert(dyn_array_set_intersection(dyn_c, dyn_a, dyn_b, &int_compare));
+    assert(DYN_IS_SORTED(dyn_c, &int_compare));
+    // more on the back, still in order
+    assert(dyn_array_set_difference(dyn_c, dyn_b, dyn_a, &int_compare));
+    assert(dyn_scan_sorted(dyn_c, &int_compare) == DYN_IS_SORTED(dyn_c, &int_compare));
+    dyn_array_clear(dyn_c);
+    // a with itself
+    assert(dyn_array_set_union(dyn_c, dyn_a, dyn_a, &int_compare));
+    assert(dyn_array_size(dyn_c) == 24);
+    assert(dyn_array_set_difference(dyn_c, dyn_a, dyn_a, &int_compare));
+    assert(dyn_array_size(dyn_c) == 24);
+    dyn_array_clear(dyn_c);
+    // wrapped ring sources
+    dyn_array_destroy(dyn_a);
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (int idx = 23; idx >= 0; --idx) {
+        assert(dyn_array_push_front(dyn_a, as + idx));
+    }
+    assert(dyn_array_set_ring_mode(dyn_c, true));
+    out = 100;
+    assert(dyn_array_push_front(dyn_c, &out) && dyn_array_push_back(dyn_c, &out));
+    assert(dyn_array_pop_front(dyn_c));
+    assert(dyn_a->head && dyn_c->head);
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &int_compare));
+    assert(dyn_array_size(dyn_c) == 45 && *((int *) dyn_array_front(dyn_c)) == 100);
+    assert(*((int *) dyn_array_at(dyn_c, 1)) == 0);
+    assert(!DYN_FLAG_CHECK(dyn_c, SORTED));
+
+    // 6 merge
+    dyn_array_clear(dyn_c);
+    assert(dyn_array_merge(NULL, dyn_a, dyn_b, &int_compare) == false);
+    assert(dyn_array_merge(dyn_c, NULL, dyn_b, &int_compare) == false);
+    assert(dyn_array_merge(dyn_c, dyn_a, NULL, &int_compare) == false);
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, NULL) == false);
+    assert(dyn_array_set_union(dyn_a, dyn_a, dyn_b, &int_compare) == false);
+    assert(dyn_array_set_difference(dyn_b, dyn_a, dyn_b, &int_compare) == false);
+    assert(dyn_array_unique(NULL, &int_compare) == 0);
+    assert(dyn_array_unique(dyn_c, NULL) == 0);
+    // 24 + 20 + 20 > DYN_MAX_CAPACITY
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &int_compare));
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &int_compare) == false);
+    assert(dyn_array_size(dyn_c) == 44);
+    dyn_array_clear(dyn_c);
+    DYN_FLAG_SET(dyn_c, READ_ONLY);
+    assert(dyn_array_set_intersection(dyn_c, dyn_a, dyn_b, &int_compare) == false);
+    assert(dyn_array_unique(dyn_c, &int_compare) == 0);
+    DYN_FLAG_UNSET(dyn_c, READ_ONLY);
+    dyn_array_destroy(dyn_c);
+    assert((dyn_c = dyn_array_create(0, sizeof(short), NULL)));
+    assert(dyn_array_merge(dyn_c, dyn_a, dyn_b, &int_compare) == false);
+    dyn_array_destroy(dyn_a);
+    dyn_array_destroy(dyn_b);
+    dyn_array_destroy(dyn_c);
+}
+
+void run_basic_tests_z() {
+    dyn_array_t *dyn_a = NULL;
+    int numbers[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, out = 0;
+
+    // 1 unordered
+    assert((dyn_a = dyn_array_import(numbers, 10, sizeof(int), NULL)));
+    assert(dyn_array_erase_unordered(dyn_a, 3));
+    assert(dyn_array_size(dyn_a) == 9 && *((int *) dyn_array_at(dyn_a, 3)) == 9);
+    assert(*((int *) dyn_array_back(dyn_a)) == 8);
+    assert(dyn_array_extract_unordered(dyn_a, 0, &out));
+    assert(out == 0 && *((int *) dyn_array_front(dyn_a)) == 8);
+    assert(dyn_array_extract_unordered(dyn_a, 7, &out));
+    assert(out == 7 && dyn_array_size(dyn_a) == 7);
+    // 8 1 2 9 4 5 6
+    const int left[7] = {8, 1, 2, 9, 4, 5, 6};
+    assert(memcmp(dyn_array_export(dyn_a), left, sizeof(left)) == 0);
+    dyn_array_destroy(dyn_a);
+
+    // 2 unordered
+    assert((dyn_a = dyn_array_create(0, DATA_BLOCK_SIZE, &block_destructor)));
+    for (int idx = 0; idx < 6; ++idx) {
+        assert(dyn_array_push_back(dyn_a, DATA_BLOCKS[idx]));
+    }
+    destruct_counter = 0;
+    assert(dyn_array_erase_unordered(dyn_a, 1));
+    assert(destruct_counter == 1);
+    assert(memcmp(dyn_array_at(dyn_a, 1), DATA_BLOCKS[5], DATA_BLOCK_SIZE) == 0);
+    uint8_t block[DATA_BLOCK_SIZE];
+    assert(dyn_array_extract_unordered(dyn_a, 2, block));
+    assert(destruct_counter == 1);
+    assert(memcmp(block, DATA_BLOCKS[2], DATA_BLOCK_SIZE) == 0);
+    assert(memcmp(dyn_array_at(dyn_a, 2), DATA_BLOCKS[4], DATA_BLOCK_SIZE) == 0);
+    assert(dyn_array_erase_unordered(dyn_a, 3));
+    assert(destruct_counter == 2 && dyn_array_size(dyn_a) == 3);
+    dyn_array_destroy(dyn_a);
+    assert(destruct_counter == 5);
+    destruct_counter = 0;
+
+    // 3 unordered
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (int idx = 0; idx < 10; ++idx) {
+        assert(dyn_array_push_front(dyn_a, numbers + idx));
+    }
+    assert(dyn_a->head);
+    // 9 8 7 ... 0
+    assert(dyn_array_erase_unordered(dyn_a, 0));
+    assert(*((int *) dyn_array_front(dyn_a)) == 0 && *((int *) dyn_array_back(dyn_a)) == 1);
+    while (dyn_array_size(dyn_a)) {
+        assert(dyn_array_extract_unordered(dyn_a, dyn_array_size(dyn_a) / 2, &out));
+    }
+    assert(dyn_a->head == 0);
+    assert(dyn_array_push_back(dyn_a, numbers + 4));
+    assert(*((int *) dyn_array_front(dyn_a)) == 4);
+    dyn_array_destroy(dyn_a);
+
+    // 4 unordered
+    assert((dyn_a = dyn_array_import(numbers, 10, sizeof(int), NULL)));
+    assert(dyn_array_is_sorted(dyn_a, &int_compare));
+    assert(dyn_array_erase_unordered(dyn_a, 9));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_extract_unordered(dyn_a, 8, &out));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_erase_unordered(dyn_a, 2));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+
+    // 5 unordered
+    assert(dyn_array_erase_unordered(dyn_a, 7) == false);
+    assert(dyn_array_extract_unordered(dyn_a, 7, &out) == false);
+    assert(dyn_array_extract_unordered(dyn_a, 0, NULL) == false);
+    assert(dyn_array_erase_unordered(NULL, 0) == false);
+    assert(dyn_array_extract_unordered(NULL, 0, &out) == false);
+    DYN_FLAG_SET(dyn_a, READ_ONLY);
+    assert(dyn_array_erase_unordered(dyn_a, 0) == false);
+    assert(dyn_array_extract_unordered(dyn_a, 0, &out) == false);
+    DYN_FLAG_UNSET(dyn_a, READ_ONLY);
+    assert(dyn_array_size(dyn_a) == 7);
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_erase_unordered(dyn_a, 0) == false);
+    assert(dyn_array_extract_unordered(dyn_a, 0, &out) == false);
+    dyn_array_destroy(dyn_a);
+}
+
+// Keys before nth are no bigger than its key, keys after are no smaller, and it's the key a sort puts there
+bool select_records_ok(const uint8_t *records, const size_t size, const size_t nth, const int expected_key) {
+    int nth_key, key;
+    memcpy(&nth_key, records + nth * size, sizeof(int));
+    if (nth_key != expected_key) {
+        return false;
+    }
+    for (size_t idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+        memcpy(&key, records + idx * size, sizeof(int));
+        if ((idx < nth && key > nth_key) || (idx > nth && key < nth_key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void run_basic_tests_aa() {
+    dyn_array_t *dyn_a = NULL;
+    const size_t sizes[3] = {4, 12, SORT_TEST_MAX_SIZE};
+    static int keys[SORT_TEST_COUNT], sorted_keys[SORT_TEST_COUNT];
+    static uint8_t records[SORT_TEST_COUNT * SORT_TEST_MAX_SIZE];
+
+    // 1 selection engine
+    srand(0x5E1E);
+    for (int pattern = 0; pattern < 7; ++pattern) {
+        for (int idx = 0; idx < SORT_TEST_COUNT; ++idx) {
+            switch (pattern) {
+                case 0: keys[idx] = rand() - RAND_MAX / 2; break;
+                case 1: keys[idx] = idx; break;
+                case 2: keys[idx] = SORT_TEST_COUNT - idx; break;
+                case 3: keys[idx] = 7; break;
+                case 4: keys[idx] = rand() % 4; break;
+                case 5: keys[idx] = idx < SORT_TEST_COUNT / 2 ? idx : SORT_TEST_COUNT - idx; break;
+                case 6: keys[idx] = idx % 100; break;
+            }
+        }
+        memcpy(sorted_keys, keys, sizeof(keys));
+        qsort(sorted_keys, SORT_TEST_COUNT, sizeof(int), &int_compare);
+        const size_t nths[5] = {0, SORT_TEST_COUNT / 2, SORT_TEST_COUNT - 1, 37, (size_t) rand() % SORT_TEST_COUNT};
+        for (int size_idx = 0; size_idx < 3; ++size_idx) {
+            for (int nth_idx = 0; nth_idx < 5; ++nth_idx) {
+                fill_sort_records(records, sizes[size_idx], keys, false);
+                dyn_select_buffer(records, SORT_TEST_COUNT, nths[nth_idx], sizes[size_idx], &int_compare);
+                assert(select_records_ok(records, sizes[size_idx], nths[nth_idx], sorted_keys[nths[nth_idx]]));
+            }
+        }
+
+        // 2 selection engine
+        dyn_sorter_t sorter;
+        dyn_sorter_init(&sorter, sizeof(int), &int_compare);
+        fill_sort_records(records, sizeof(int), keys, false);
+        dyn_select(&sorter, records, SORT_TEST_COUNT, SORT_TEST_COUNT / 3, 1, true);
+        assert(select_records_ok(records, sizeof(int), SORT_TEST_COUNT / 3, sorted_keys[SORT_TEST_COUNT / 3]));
+
+        // 3 selection engine
+        const size_t ks[3] = {1, 50, SORT_TEST_COUNT};
+        for (int k_idx = 0; k_idx < 3; ++k_idx) {
+            size_t filled = 0;
+            dyn_top_k_feed(&sorter, (const uint8_t *) keys, 1000, records, ks[k_idx], &filled);
+            dyn_top_k_feed(&sorter, (const uint8_t *) (keys + 1000), SORT_TEST_COUNT - 1000, records, ks[k_idx], &filled);
+            assert(filled == ks[k_idx]);
+            dyn_top_k_finish(&sorter, records, ks[k_idx]);
+            for (size_t idx = 0; idx < ks[k_idx]; ++idx) {
+                assert(((int *) records)[idx] == sorted_keys[SORT_TEST_COUNT - 1 - idx]);
+            }
+        }
+    }
+
+    int numbers[60], top[64], before[60];
+    for (int idx = 0; idx < 60; ++idx) {
+        numbers[idx] = (idx * 37) % 50;
+    }
+    memcpy(sorted_keys, numbers, sizeof(numbers));
+    qsort(sorted_keys, 60, sizeof(int), &int_compare);
+
+    // 1 selection
+    for (size_t nth = 0; nth < 60; nth += 7) {
+        assert((dyn_a = dyn_array_import(numbers, 60, sizeof(int), NULL)));
+        assert(dyn_array_nth_element(dyn_a, nth, &int_compare));
+        const int nth_value = *((int *) dyn_array_at(dyn_a, nth));
+        assert(nth_value == sorted_keys[nth]);
+        for (size_t idx = 0; idx < 60; ++idx) {
+            const int value = *((int *) dyn_array_at(dyn_a, idx));
+            assert(idx < nth ? value <= nth_value : value >= nth_value);
+        }
+        dyn_array_destroy(dyn_a);
+    }
+
+    // 2 selection
+    const size_t ks[5] = {0, 1, 10, 59, 60};
+    for (int k_idx = 0; k_idx < 5; ++k_idx) {
+        assert((dyn_a = dyn_array_import(numbers, 60, sizeof(int), NULL)));
+        assert(dyn_array_partial_sort(dyn_a, ks[k_idx], &int_compare));
+        assert(memcmp(dyn_array_export(dyn_a), sorted_keys, ks[k_idx] * sizeof(int)) == 0);
+        // still all there
+        qsort((void *) dyn_array_export(dyn_a), 60, sizeof(int), &int_compare);
+        assert(memcmp(dyn_array_export(dyn_a), sorted_keys, sizeof(sorted_keys[0]) * 60) == 0);
+        dyn_array_destroy(dyn_a);
+    }
+    assert((dyn_a = dyn_array_import(numbers, 60, sizeof(int), NULL)));
+    assert(dyn_array_partial_sort(dyn_a, 100, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    dyn_array_destroy(dyn_a);
+
+    // 3 selection
+    assert((dyn_a = dyn_array_import(numbers, 60, sizeof(int), NULL)));
+    memcpy(before, dyn_array_export(dyn_a), sizeof(before));
+    assert(dyn_array_top_k(dyn_a, 5, top, &int_compare) == 5);
+    for (int idx = 0; idx < 5; ++idx) {
+        assert(top[idx] == sorted_keys[59 - idx]);
+    }
+    assert(memcmp(dyn_array_export(dyn_a), before, sizeof(before)) == 0);
+    assert(dyn_array_top_k(dyn_a, 64, top, &int_compare) == 60);
+    for (int idx = 0; idx < 60; ++idx) {
+        assert(top[idx] == sorted_keys[59 - idx]);
+    }
+    // smallest first, with the comparator flipped
+    assert(dyn_array_top_k(dyn_a, 3, top, &int_compare_inv) == 3);
+    assert(top[0] == sorted_keys[0] && top[1] == sorted_keys[1] && top[2] == sorted_keys[2]);
+    dyn_array_destroy(dyn_a);
+
+    // 4 selection
+    assert((dyn_a = dyn_array_create(0, sizeof(int), NULL)));
+    assert(dyn_array_set_ring_mode(dyn_a, true));
+    for (int idx = 59; idx >= 0; --idx) {
+        assert(dyn_array_push_front(dyn_a, numbers + idx));
+    }
+    assert(dyn_a->head);
+    assert(dyn_array_top_k(dyn_a, 8, top, &int_compare) == 8);
+    for (int idx = 0; idx < 8; ++idx) {
+        assert(top[idx] == sorted_keys[59 - idx]);
+    }
+    assert(dyn_a->head);
+    assert(dyn_array_nth_element(dyn_a, 30, &int_compare));
+    assert(*((int *) dyn_array_at(dyn_a, 30)) == sorted_keys[30]);
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_nth_element(dyn_a, 12, &int_compare));
+    assert(dyn_array_partial_sort(dyn_a, 12, &int_compare));
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_top_k(dyn_a, 8, top, &int_compare) == 8);
+    for (int idx = 0; idx < 8; ++idx) {
+        assert(top[idx] == sorted_keys[59 - idx]);
+    }
+    assert(DYN_IS_SORTED(dyn_a, &int_compare));
+    assert(dyn_array_nth_element(dyn_a, 12, &int_compare_inv));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(*((int *) dyn_array_at(dyn_a, 12)) == sorted_keys[47]);
+    assert(dyn_array_sort(dyn_a, &int_compare));
+    assert(dyn_array_partial_sort(dyn_a, 5, &int_compare_inv));
+    assert(!DYN_FLAG_CHECK(dyn_a, SORTED));
+    assert(*((int *) dyn_array_front(dyn_a)) == sorted_keys[59]);
+
+    // 5 selection
+    assert(dyn_array_nth_element(dyn_a, 60, &int_compare) == false);
+    assert(dyn_array_nth_element(dyn_a, 0, NULL) == false);
+    assert(dyn_array_nth_element(NULL, 0, &int_compare) == false);
+    assert(dyn_array_partial_sort(dyn_a, 5, NULL) == false);
+    assert(dyn_array_partial_sort(NULL, 5, &int_compare) == false);
+    assert(dyn_array_top_k(dyn_a, 5, NULL, &int_compare) == 0);
+    assert(dyn_array_top_k(dyn_a, 5, top, NULL) == 0);
+    assert(dyn_array_top_k(NULL, 5, top, &int_compare) == 0);
+    assert(dyn_array_top_k(dyn_a, 0, top, &int_compare) == 0);
+    DYN_FLAG_SET(dyn_a, READ_ONLY);
+    assert(dyn_array_nth_element(dyn_a, 0, &int_compare) == false);
+    assert(dyn_array_partial_sort(dyn_a, 5, &int_compare) == false);
+    // reading is fine
+    assert(dyn_array_top_k(dyn_a, 5, top, &int_compare) == 5);
+    DYN_FLAG_UNSET(dyn_a, READ_ONLY);
+    dyn_array_clear(dyn_a);
+    assert(dyn_array_nth_element(dyn_a, 0, &int_compare) == false);
+    assert(dyn_array_partial_sort(dyn_a, 5, &int_compare));
+    assert(dyn_array_top_k(dyn_a, 5, top, &int_compare) == 0);
+    dyn_array_destroy(dyn_a);
+}